@@ -2,7 +2,9 @@
 
 # This CMake script will build and run a CPUID utility.
 # It detects processor features and writes a cpuinfo.json file,
-# containing cpu vendor, brand, isa-features and architecture level.
+# containing cpu vendor, brand, isa-features, cache sizes, speculative-execution mitigations,
+# measured syscall and context switch overhead and architecture level.
+# It supports x86 (CPUID) and aarch64 Linux (hwcaps) hosts.
 #
 # The variable CPUINFO_OK is set in case of a successful compilation and run.
 # If successful, we can read the json file, check each feature
@@ -14,9 +16,9 @@ include (CMakePushCheckState)
 cmake_push_check_state ()
 
 if(CMAKE_CXX_COMPILER_ID STREQUAL "Clang")
-  set(CMAKE_REQUIRED_FLAGS "-std=c++11 -lstdc++")
+  set(CMAKE_REQUIRED_FLAGS "-std=c++14 -lstdc++")
 elseif(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
-  set(CMAKE_REQUIRED_FLAGS "-std=c++11")
+  set(CMAKE_REQUIRED_FLAGS "-std=c++14")
 elseif(CMAKE_CXX_COMPILER_ID STREQUAL "MSVC")
   # /EHsc catches C++ exceptions only and tells the compiler to assume that
   # extern C functions never throw a C++ exception.
@@ -45,29 +47,51 @@ endif()
 if(CPUINFO_OK)
   file(READ "${CMAKE_BINARY_DIR}/cpuinfo.json" CPUINFO_JSON_STRING)
 
-  string(JSON CPUINFO_CPU_OBJECT   GET ${CPUINFO_JSON_STRING} "cpu")
+  # the json is quoted, because the vulnerability strings contain semicolons
+  string(JSON CPUINFO_CPU_OBJECT   GET "${CPUINFO_JSON_STRING}" "cpu")
   string(JSON CPUINFO_VENDOR       GET ${CPUINFO_CPU_OBJECT}  "vendor") # cpu.vendor
   string(JSON CPUINFO_BRAND        GET ${CPUINFO_CPU_OBJECT}  "brand")  # cpu.brand
 
   # access the "isa-features" object
-  string(JSON CPUINFO_ISA_OBJECT   GET ${CPUINFO_JSON_STRING} "isa-features")
-  string(JSON HAS_SSE2             GET ${CPUINFO_ISA_OBJECT}  "SSE2") # isa-features.SSE2
-  string(JSON HAS_SSE3             GET ${CPUINFO_ISA_OBJECT}  "SSE3") # isa-features.SSE3
+  # the features depend on the architecture (x86 or aarch64), missing features are set to OFF
+  string(JSON CPUINFO_ISA_OBJECT   GET "${CPUINFO_JSON_STRING}" "isa-features")
+  foreach(CPUINFO_FEATURE SSE2 SSE3 NEON SVE)
+    string(JSON HAS_${CPUINFO_FEATURE} ERROR_VARIABLE CPUINFO_FEATURE_ERROR GET ${CPUINFO_ISA_OBJECT} "${CPUINFO_FEATURE}")
+    if(CPUINFO_FEATURE_ERROR)
+      set(HAS_${CPUINFO_FEATURE} OFF)
+    endif()
+  endforeach()
 
-  string(JSON CPUINFO_ARCHITECTURE_LEVEL   GET ${CPUINFO_JSON_STRING} "architecture")
+  # access the "vector" object, the SVE vector length in bits is only reported on aarch64
+  string(JSON CPUINFO_SVE_VECTOR_LENGTH ERROR_VARIABLE CPUINFO_FEATURE_ERROR GET "${CPUINFO_JSON_STRING}" "vector" "sve_vector_length") # vector.sve_vector_length
+  if(CPUINFO_FEATURE_ERROR)
+    set(CPUINFO_SVE_VECTOR_LENGTH 0)
+  endif()
+
+  # access the "kernel-overhead" object, values are empty if not measured
+  string(JSON CPUINFO_KERNEL_OBJECT     GET "${CPUINFO_JSON_STRING}"  "kernel-overhead")
+  string(JSON CPUINFO_SYSCALL_NS        GET ${CPUINFO_KERNEL_OBJECT}  "syscall_ns")        # kernel-overhead.syscall_ns
+  string(JSON CPUINFO_CONTEXT_SWITCH_NS GET ${CPUINFO_KERNEL_OBJECT}  "context_switch_ns") # kernel-overhead.context_switch_ns
+
+  string(JSON CPUINFO_ARCHITECTURE_LEVEL   GET "${CPUINFO_JSON_STRING}" "architecture")
 
   message(STATUS "[CPU_INFO] Overview:")
   message(STATUS "[CPU_INFO]  - Dataset            -> ${CMAKE_BINARY_DIR}/cpuinfo.json")
   message(STATUS "[CPU_INFO]  - Vendor             -> ${CPUINFO_VENDOR}")
   message(STATUS "[CPU_INFO]  - Brand              -> ${CPUINFO_BRAND}")
   message(STATUS "[CPU_INFO]  - Architecture Level -> ${CPUINFO_ARCHITECTURE_LEVEL}")
+  message(STATUS "[CPU_INFO]  - Syscall            -> ${CPUINFO_SYSCALL_NS} ns")
+  message(STATUS "[CPU_INFO]  - Context Switch     -> ${CPUINFO_CONTEXT_SWITCH_NS} ns")
 
   # print cpu feature flags
   message(STATUS "[CPU_INFO] CPU feature flags:")
   message(STATUS "[CPU_INFO]  - HAS_SSE2           -> ${HAS_SSE2}")
   message(STATUS "[CPU_INFO]  - HAS_SSE3           -> ${HAS_SSE3}")
+  message(STATUS "[CPU_INFO]  - HAS_NEON           -> ${HAS_NEON}")
+  message(STATUS "[CPU_INFO]  - HAS_SVE            -> ${HAS_SVE} (vector length ${CPUINFO_SVE_VECTOR_LENGTH} bits)")
 
   # architecture levels
+  set(HOST_IS_AARCH64  FALSE)
   set(HOST_IS_X86_64_1 FALSE)
   set(HOST_IS_X86_64_2 FALSE)
   set(HOST_IS_X86_64_3 FALSE)
@@ -87,8 +111,158 @@ if(CPUINFO_OK)
     set(HOST_IS_X86_64_1 TRUE)
   elseif(${CPUINFO_ARCHITECTURE_LEVEL} STREQUAL "x86-64-v1")
     set(HOST_IS_X86_64_1 TRUE) 
+  elseif(${CPUINFO_ARCHITECTURE_LEVEL} MATCHES "^(armv|aarch64)")
+    # aarch64: the level is a -march value, e.g. "armv8.2-a" or "armv9-a"
+    set(HOST_IS_AARCH64 TRUE)
   else()
     message(WARNING "Architecture level does not match any expected value: ${CPUINFO_ARCHITECTURE_LEVEL}")
   endif()
 
 endif()
+
+# cpuinfo_autotune() benchmarks variants of a kernel on this host and picks the fastest.
+#
+# Usage:
+#
+#   cpuinfo_autotune(NAME <id> SOURCES <variant1.cpp> <variant2.cpp> ... [COMPILE_OPTIONS <options>...])
+#
+# Each variant defines "void cpuinfo_autotune_kernel()", which does one unit of work.
+# Make sure that the compiler can't optimize the work away: work on data, which is only known
+# at runtime, and write the result to a volatile.
+#
+# Each variant is compiled in Release mode as a separate source file next to a timing harness
+# and run by try_run(). The harness calls the kernel through a volatile function pointer,
+# so the kernel can't be inlined into the timing loop and folded across iterations.
+# try_run() is the same build-and-run mechanism check_cxx_source_runs() uses for the cpuinfo source above.
+# The harness repeats the kernel until a batch takes at least 20 ms and reports the best of 5 batches.
+#
+# Sets CPUINFO_AUTOTUNE_<id> to the source file of the fastest variant and writes
+# the timings to the "autotune" object of cpuinfo.json, keyed by the source paths as given in SOURCES.
+#
+# The result is cached. Tuning runs again only if the cpu brand, the architecture level,
+# the harness, the variant sources or the compile options change.
+
+set(CPUINFO_AUTOTUNE_HARNESS [=[
+#include <chrono>
+#include <iostream>
+
+// defined by the variant, which is a separate source file
+void cpuinfo_autotune_kernel();
+
+int main()
+{
+    using clock = std::chrono::steady_clock;
+
+    // an opaque call, the kernel is neither inlined nor hoisted out of the loops
+    void (* volatile kernel)() = &cpuinfo_autotune_kernel;
+
+    // grow the batch, until the timer resolution doesn't matter
+    long long reps = 1;
+    for (;;)
+    {
+        const auto start = clock::now();
+        for (long long i = 0; i < reps; ++i) { kernel(); }
+        if (clock::now() - start >= std::chrono::milliseconds(20) || reps >= (1LL << 40)) { break; }
+        reps *= 2;
+    }
+
+    double best_ns = -1;
+    for (int run = 0; run < 5; ++run)
+    {
+        const auto start = clock::now();
+        for (long long i = 0; i < reps; ++i) { kernel(); }
+        const double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / reps;
+        if (best_ns < 0 || ns < best_ns) { best_ns = ns; }
+    }
+
+    std::cout << "CPUINFO_AUTOTUNE_NS=" << best_ns << std::endl;
+    return 0;
+}
+]=])
+
+function(cpuinfo_autotune)
+  cmake_parse_arguments(ARG "" "NAME" "SOURCES;COMPILE_OPTIONS" ${ARGN})
+
+  if(NOT ARG_NAME OR NOT ARG_SOURCES)
+    message(FATAL_ERROR "cpuinfo_autotune: NAME and SOURCES are required.")
+  endif()
+
+  set(CPUINFO_JSON_FILE "${CMAKE_BINARY_DIR}/cpuinfo.json")
+  file(READ "${CPUINFO_JSON_FILE}" CPUINFO_JSON_STRING)
+  string(JSON CPUINFO_CPU_OBJECT    GET "${CPUINFO_JSON_STRING}" "cpu")
+  string(JSON CPUINFO_BRAND         GET ${CPUINFO_CPU_OBJECT}    "brand")
+  string(JSON CPUINFO_ARCHITECTURE  GET "${CPUINFO_JSON_STRING}" "architecture")
+
+  # the host type, the harness and the variant sources make up the cache key
+  string(SHA1 HARNESS_HASH "${CPUINFO_AUTOTUNE_HARNESS}")
+  set(AUTOTUNE_KEY "${CPUINFO_BRAND}|${CPUINFO_ARCHITECTURE}|${ARG_COMPILE_OPTIONS}|${HARNESS_HASH}")
+  foreach(VARIANT IN LISTS ARG_SOURCES)
+    get_filename_component(VARIANT_PATH "${VARIANT}" ABSOLUTE)
+    file(SHA1 "${VARIANT_PATH}" VARIANT_HASH)
+    string(APPEND AUTOTUNE_KEY "|${VARIANT}:${VARIANT_HASH}")
+  endforeach()
+  string(SHA1 AUTOTUNE_KEY "${AUTOTUNE_KEY}")
+
+  if(NOT "${CPUINFO_AUTOTUNE_${ARG_NAME}_KEY}" STREQUAL "${AUTOTUNE_KEY}")
+    set(CMAKE_TRY_COMPILE_CONFIGURATION Release)
+    set(AUTOTUNE_DIR "${CMAKE_BINARY_DIR}/CMakeFiles/cpuinfo_autotune/${ARG_NAME}")
+    set(AUTOTUNE_RESULTS "{}")
+    set(AUTOTUNE_WINNER "")
+    set(AUTOTUNE_WINNER_NS "")
+
+    set(HARNESS_FILE "${AUTOTUNE_DIR}/cpuinfo_autotune_harness.cpp")
+    file(WRITE "${HARNESS_FILE}" "${CPUINFO_AUTOTUNE_HARNESS}")
+
+    foreach(VARIANT IN LISTS ARG_SOURCES)
+      get_filename_component(VARIANT_PATH "${VARIANT}" ABSOLUTE)
+
+      # harness and variant are separate translation units
+      try_run(AUTOTUNE_RUN_RESULT AUTOTUNE_COMPILE_RESULT "${AUTOTUNE_DIR}"
+        SOURCES "${HARNESS_FILE}" "${VARIANT_PATH}"
+        COMPILE_DEFINITIONS ${ARG_COMPILE_OPTIONS}
+        COMPILE_OUTPUT_VARIABLE AUTOTUNE_COMPILE_OUTPUT
+        RUN_OUTPUT_VARIABLE AUTOTUNE_RUN_OUTPUT
+      )
+
+      if(NOT AUTOTUNE_COMPILE_RESULT OR NOT "${AUTOTUNE_RUN_RESULT}" STREQUAL "0"
+         OR NOT AUTOTUNE_RUN_OUTPUT MATCHES "CPUINFO_AUTOTUNE_NS=([0-9.e+-]+)")
+        message(WARNING "[CPU_INFO] Autotune ${ARG_NAME}: variant ${VARIANT} failed, skipping it.\n${AUTOTUNE_COMPILE_OUTPUT}")
+        continue()
+      endif()
+      set(VARIANT_NS "${CMAKE_MATCH_1}")
+
+      # keyed by the path as given in SOURCES, base names may repeat (e.g. avx2/kernel.cpp, sse/kernel.cpp)
+      string(JSON AUTOTUNE_RESULTS SET "${AUTOTUNE_RESULTS}" "${VARIANT}" "${VARIANT_NS}")
+      message(STATUS "[CPU_INFO] Autotune ${ARG_NAME}: ${VARIANT} -> ${VARIANT_NS} ns")
+
+      if("${AUTOTUNE_WINNER}" STREQUAL "" OR VARIANT_NS LESS AUTOTUNE_WINNER_NS)
+        set(AUTOTUNE_WINNER "${VARIANT}")
+        set(AUTOTUNE_WINNER_NS "${VARIANT_NS}")
+      endif()
+    endforeach()
+
+    if("${AUTOTUNE_WINNER}" STREQUAL "")
+      message(FATAL_ERROR "[CPU_INFO] Autotune ${ARG_NAME}: no variant could be compiled and run. CMake Exit.")
+    endif()
+
+    set(AUTOTUNE_ENTRY "{}")
+    string(JSON AUTOTUNE_ENTRY SET "${AUTOTUNE_ENTRY}" "winner"  "\"${AUTOTUNE_WINNER}\"")
+    string(JSON AUTOTUNE_ENTRY SET "${AUTOTUNE_ENTRY}" "results" "${AUTOTUNE_RESULTS}")
+    # cache entries are single-line
+    string(REPLACE "\n" "" AUTOTUNE_ENTRY "${AUTOTUNE_ENTRY}")
+
+    set(CPUINFO_AUTOTUNE_${ARG_NAME}         "${AUTOTUNE_WINNER}" CACHE INTERNAL "Fastest variant of ${ARG_NAME}")
+    set(CPUINFO_AUTOTUNE_${ARG_NAME}_RESULTS "${AUTOTUNE_ENTRY}"  CACHE INTERNAL "Autotune results of ${ARG_NAME}")
+    set(CPUINFO_AUTOTUNE_${ARG_NAME}_KEY     "${AUTOTUNE_KEY}"    CACHE INTERNAL "Autotune cache key of ${ARG_NAME}")
+  endif()
+
+  message(STATUS "[CPU_INFO] Autotune ${ARG_NAME}: CPUINFO_AUTOTUNE_${ARG_NAME} -> ${CPUINFO_AUTOTUNE_${ARG_NAME}}")
+
+  # (re-)write the results, because cpuinfo.json is regenerated, when the cpuinfo check runs again
+  string(JSON AUTOTUNE_OBJECT ERROR_VARIABLE AUTOTUNE_JSON_ERROR GET "${CPUINFO_JSON_STRING}" "autotune")
+  if(AUTOTUNE_JSON_ERROR)
+    string(JSON CPUINFO_JSON_STRING SET "${CPUINFO_JSON_STRING}" "autotune" "{}")
+  endif()
+  string(JSON CPUINFO_JSON_STRING SET "${CPUINFO_JSON_STRING}" "autotune" "${ARG_NAME}" "${CPUINFO_AUTOTUNE_${ARG_NAME}_RESULTS}")
+  file(WRITE "${CPUINFO_JSON_FILE}" "${CPUINFO_JSON_STRING}")
+endfunction()
@@ -3,8 +3,12 @@
 // Uses the __cpuid intrinsic to get information
 // about CPU extended instruction set support.
 
+#include <algorithm>
 #include <array>
 #include <bitset>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -20,204 +24,306 @@
 #include <string.h>
 #endif
 
+#if defined(__linux__)
+#include <dirent.h>      // opendir, readdir
+#include <fcntl.h>       // open
+#include <signal.h>      // sigtimedwait, kill
+#include <sched.h>       // sched_setaffinity, sched_getcpu
+#include <sys/stat.h>    // stat
+#include <sys/syscall.h> // SYS_getppid
+#include <sys/wait.h>    // waitpid
+#include <unistd.h>      // fork, pipe, syscall, execv, access
+#include <cerrno>
+#include <cstdlib>       // setenv
+#include <cstring>       // strerror
+#endif
+
+#if defined(__linux__) && (defined(__i386__) || defined(__x86_64__))
+#include <x86intrin.h>   // __rdtsc
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>    // getauxval
+#include <sys/prctl.h>   // PR_SVE_GET_VL
+#endif
+
 class InstructionSet
 {
-    // forward declarations
-    class InstructionSet_Internal;
-
 public:
     // getters
-    static std::string Vendor(void) { return CPU_Rep.vendor_; }
-    static std::string Brand(void)  { return CPU_Rep.brand_;  }
+    static std::string Vendor(void) { return CPU_Rep().vendor_; }
+    static std::string Brand(void)  { return CPU_Ext().brand_;  }
+
+    // XFEATURE_ENABLED_MASK: the register state components enabled by the OS, 0 if OSXSAVE is not set
+    static unsigned long long XCR0(void) { return CPU_Rep().xcr0_; }
 
     // EDX Register
     // Intel-defined CPU features, CPUID level 0x00000001 (EDX), word 0
 
-    static bool FPU(void)   { return CPU_Rep.f_1_EDX_[0];  } // Floating-point Unit On-Chip
-    static bool VME(void)   { return CPU_Rep.f_1_EDX_[1];  } // Virtual Mode Extension
-    static bool DE(void)    { return CPU_Rep.f_1_EDX_[2];  } // Debugging Extension
-    static bool PSE(void)   { return CPU_Rep.f_1_EDX_[3];  } // Page Size Extension
-    static bool TSC(void)   { return CPU_Rep.f_1_EDX_[4];  } // Time Stamp Counter
-    static bool MSR(void)   { return CPU_Rep.f_1_EDX_[5];  } // Model Specific Registers: RDMSR, WRMSR.
-    static bool PAE(void)   { return CPU_Rep.f_1_EDX_[6];  } // Physical Address Extension
-    static bool MCE(void)   { return CPU_Rep.f_1_EDX_[7];  } // Machine-Check Exception
-    static bool CX8(void)   { return CPU_Rep.f_1_EDX_[8];  } // CMPXCHG8 instruction
-    static bool APIC(void)  { return CPU_Rep.f_1_EDX_[9];  } // On-chip APIC Hardware
+    static bool FPU(void)   { return CPU_Rep().f_1_EDX_[0];  } // Floating-point Unit On-Chip
+    static bool VME(void)   { return CPU_Rep().f_1_EDX_[1];  } // Virtual Mode Extension
+    static bool DE(void)    { return CPU_Rep().f_1_EDX_[2];  } // Debugging Extension
+    static bool PSE(void)   { return CPU_Rep().f_1_EDX_[3];  } // Page Size Extension
+    static bool TSC(void)   { return CPU_Rep().f_1_EDX_[4];  } // Time Stamp Counter
+    static bool MSR(void)   { return CPU_Rep().f_1_EDX_[5];  } // Model Specific Registers: RDMSR, WRMSR.
+    static bool PAE(void)   { return CPU_Rep().f_1_EDX_[6];  } // Physical Address Extension
+    static bool MCE(void)   { return CPU_Rep().f_1_EDX_[7];  } // Machine-Check Exception
+    static bool CX8(void)   { return CPU_Rep().f_1_EDX_[8];  } // CMPXCHG8 instruction
+    static bool APIC(void)  { return CPU_Rep().f_1_EDX_[9];  } // On-chip APIC Hardware
                                       // reserved bit 10
-    static bool SEP(void)   { return CPU_Rep.f_1_EDX_[11]; } // Fast System Call: SYSENTER, SYSEXIT.
-    static bool MTRR(void)  { return CPU_Rep.f_1_EDX_[12]; } // Memory Type Range Registers: MTRR_CAP register.
-    static bool PGE(void)   { return CPU_Rep.f_1_EDX_[13]; } // Page Global Enable
-    static bool MCA(void)   { return CPU_Rep.f_1_EDX_[14]; } // Machine-Check Architecture: MCG_CAP register.
-    static bool CMOV(void)  { return CPU_Rep.f_1_EDX_[15]; } // Conditional Move Instruction: CMOV, FCMOVcc, FCOMI with FPU.
-    static bool PAT(void)   { return CPU_Rep.f_1_EDX_[16]; } // Page Attribute Table
-    static bool PSE36(void) { return CPU_Rep.f_1_EDX_[17]; } // 36-bit Page Size Extension: Processor supports 4MB pages addressing beyond 4GB physical memory.
-    static bool PN(void)    { return CPU_Rep.f_1_EDX_[18]; } // Processor serial number
-    static bool CLFSH(void) { return CPU_Rep.f_1_EDX_[19]; } // CLFLUSH instruction
-    //static bool NX(void)    { return CPU_Rep.f_1_EDX_[20]; }
-    static bool DS(void)    { return CPU_Rep.f_1_EDX_[21]; } // "dts" Debug Store: branch trace store (BTS), precise event-based sampling (PEBS).
-    static bool ACPI(void)  { return CPU_Rep.f_1_EDX_[22]; } // Thermal Monitor and Software Controlled Clock Facilities
-    static bool MMX(void)   { return CPU_Rep.f_1_EDX_[23]; } // MMX technology
-    static bool FXSR(void)  { return CPU_Rep.f_1_EDX_[24]; } // FXSAVE/FXRSTOR, CR4.OSFXSR
-    static bool SSE(void)   { return CPU_Rep.f_1_EDX_[25]; } // Streaming SIMD Extensions
-    static bool SSE2(void)  { return CPU_Rep.f_1_EDX_[26]; } // Streaming SIMD Extensions 2
-    static bool SS(void)    { return CPU_Rep.f_1_EDX_[27]; } // "ss" Self-Snoop CPU cache structure.
-    static bool HTT(void)   { return CPU_Rep.f_1_EDX_[28]; } // Hyper-Threading/Multi-Threading
-    static bool TM(void)    { return CPU_Rep.f_1_EDX_[29]; } // "tm" Thermal Monitor clock control
-    static bool IA64(void)  { return CPU_Rep.f_1_EDX_[30]; } // IA64 processor emulating x86
-    static bool PBE(void)   { return CPU_Rep.f_1_EDX_[31]; } // Pending Break Enable
+    static bool SEP(void)   { return CPU_Rep().f_1_EDX_[11]; } // Fast System Call: SYSENTER, SYSEXIT.
+    static bool MTRR(void)  { return CPU_Rep().f_1_EDX_[12]; } // Memory Type Range Registers: MTRR_CAP register.
+    static bool PGE(void)   { return CPU_Rep().f_1_EDX_[13]; } // Page Global Enable
+    static bool MCA(void)   { return CPU_Rep().f_1_EDX_[14]; } // Machine-Check Architecture: MCG_CAP register.
+    static bool CMOV(void)  { return CPU_Rep().f_1_EDX_[15]; } // Conditional Move Instruction: CMOV, FCMOVcc, FCOMI with FPU.
+    static bool PAT(void)   { return CPU_Rep().f_1_EDX_[16]; } // Page Attribute Table
+    static bool PSE36(void) { return CPU_Rep().f_1_EDX_[17]; } // 36-bit Page Size Extension: Processor supports 4MB pages addressing beyond 4GB physical memory.
+    static bool PN(void)    { return CPU_Rep().f_1_EDX_[18]; } // Processor serial number
+    static bool CLFSH(void) { return CPU_Rep().f_1_EDX_[19]; } // CLFLUSH instruction
+    //static bool NX(void)    { return CPU_Rep().f_1_EDX_[20]; }
+    static bool DS(void)    { return CPU_Rep().f_1_EDX_[21]; } // "dts" Debug Store: branch trace store (BTS), precise event-based sampling (PEBS).
+    static bool ACPI(void)  { return CPU_Rep().f_1_EDX_[22]; } // Thermal Monitor and Software Controlled Clock Facilities
+    static bool MMX(void)   { return CPU_Rep().f_1_EDX_[23]; } // MMX technology
+    static bool FXSR(void)  { return CPU_Rep().f_1_EDX_[24]; } // FXSAVE/FXRSTOR, CR4.OSFXSR
+    static bool SSE(void)   { return CPU_Rep().f_1_EDX_[25]; } // Streaming SIMD Extensions
+    static bool SSE2(void)  { return CPU_Rep().f_1_EDX_[26]; } // Streaming SIMD Extensions 2
+    static bool SS(void)    { return CPU_Rep().f_1_EDX_[27]; } // "ss" Self-Snoop CPU cache structure.
+    static bool HTT(void)   { return CPU_Rep().f_1_EDX_[28]; } // Hyper-Threading/Multi-Threading
+    static bool TM(void)    { return CPU_Rep().f_1_EDX_[29]; } // "tm" Thermal Monitor clock control
+    static bool IA64(void)  { return CPU_Rep().f_1_EDX_[30]; } // IA64 processor emulating x86
+    static bool PBE(void)   { return CPU_Rep().f_1_EDX_[31]; } // Pending Break Enable
 
     // EDX Register
     // AMD-defined CPU features, CPUID level 0x80000001, word 1
 
-    static bool SYSCALL(void)    { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[11]; } // SYSCALL/SYSRET
+    static bool SYSCALL(void)    { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[11]; } // SYSCALL/SYSRET
                                                                    // 12-18
-    static bool MP(void)         { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[19]; } // MP Capable
-    static bool NX(void)         { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[20]; } // Execute Disable
-    static bool MMXEXT(void)     { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[22]; } // AMD MMX extensions
-    static bool FXSR_OPT(void)   { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[25]; } // FXSAVE/FXRSTOR optimizations
-    static bool GBPAGES(void)    { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[26]; } // "pdpe1gb" GB pages
-    static bool RDTSCP(void)     { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[27]; } // RDTSCP: Read Time-Stamp Counter and Processor ID.
+    static bool MP(void)         { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[19]; } // MP Capable
+    static bool NX(void)         { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[20]; } // Execute Disable
+    static bool MMXEXT(void)     { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[22]; } // AMD MMX extensions
+    static bool FXSR_OPT(void)   { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[25]; } // FXSAVE/FXRSTOR optimizations
+    static bool GBPAGES(void)    { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[26]; } // "pdpe1gb" GB pages
+    static bool RDTSCP(void)     { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[27]; } // RDTSCP: Read Time-Stamp Counter and Processor ID.
                                                       // reserved bit 28
-    static bool LM(void)         { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[29]; } // Long Mode (x86-64, 64-bit support)
-    static bool _3DNOWEXT(void)  { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[30]; } // AMD 3DNow extensions
-    static bool _3DNOW(void)     { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[31]; } // 3DNow
+    static bool LM(void)         { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[29]; } // Long Mode (x86-64, 64-bit support)
+    static bool _3DNOWEXT(void)  { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[30]; } // AMD 3DNow extensions
+    static bool _3DNOW(void)     { return CPU_Rep().isAMD_ && CPU_Rep().f_81_EDX_[31]; } // 3DNow
 
     // ECX register
     // Intel-defined CPU features, CPUID level 0x00000001 (ECX), word 4
 
-    static bool SSE3(void)         { return CPU_Rep.f_1_ECX_[0];  } // Streaming SIMD Extensions 3, XMM3, "pni"
-    static bool PCLMULQDQ(void)    { return CPU_Rep.f_1_ECX_[1];  } // PCLMULQDQ instruction
-    static bool DTES64(void)       { return CPU_Rep.f_1_ECX_[2];  } // 64-Bit Debug Store
-    static bool MONITOR(void)      { return CPU_Rep.f_1_ECX_[3];  } // Processor supports MONITOR and MWAIT instructions
-    static bool DS_CPL(void)       { return CPU_Rep.f_1_ECX_[4];  } // "ds_cpl" CPL Qualified (filtered) Debug Store
-    static bool VMX(void)          { return CPU_Rep.f_1_ECX_[5];  } // Virtual Machine Extensions. Processor supports Virtualization Technology.
-    static bool SMX(void)          { return CPU_Rep.f_1_ECX_[6];  } // Safer Mode Extensions. Processor supports  Trusted Execution Technology.
-    static bool EST(void)          { return CPU_Rep.f_1_ECX_[7];  } // Enhanced SpeedStep Technology. Has IA32_PERF_STS and IA32_PERF_CTL registers.
-    static bool TM2(void)          { return CPU_Rep.f_1_ECX_[8];  } // Thermal Monitor 2
-    static bool SSSE3(void)        { return CPU_Rep.f_1_ECX_[9];  } // Supplemental Streaming SIMD Extensions 3, "sse3", SSE-3.
-    static bool CNXT_ID(void)      { return CPU_Rep.f_1_ECX_[10]; } // L1 Context ID - L1 data cache mode is set to adaptive mode or shared in BIOS.
-    static bool SDBG(void)         { return CPU_Rep.f_1_ECX_[11]; } // Silicon Debug interface. IA32_DEBUG_INTERFACE
-    static bool FMA(void)          { return CPU_Rep.f_1_ECX_[12]; } // Fused Multiply Add. The processor supports FMA extensions using YMM state.
-    static bool CMPXCHG16B(void)   { return CPU_Rep.f_1_ECX_[13]; } // CMPXCHG16B instruction
-    static bool PCID(void)         { return CPU_Rep.f_1_ECX_[17]; } // Process Context Identifiers
-    static bool DCA(void)          { return CPU_Rep.f_1_ECX_[18]; } // Direct Cache Access. Processor supports data prefetch from memory mapped device.
-    static bool SSE41(void)        { return CPU_Rep.f_1_ECX_[19]; } // Streaming SIMD Extensions 4.1, "sse4_1", SSE-4.1.
-    static bool SSE42(void)        { return CPU_Rep.f_1_ECX_[20]; } // Streaming SIMD Extensions 4.2, "sse4_2", SSE-4.2.
-    static bool X2APIC(void)       { return CPU_Rep.f_1_ECX_[21]; } // Extended xAPIC Support
-    static bool MOVBE(void)        { return CPU_Rep.f_1_ECX_[22]; } // MOVBE instruction
-    static bool POPCNT(void)       { return CPU_Rep.f_1_ECX_[23]; } // POPCNT instruction
-    static bool TSC_DEADLINE(void) { return CPU_Rep.f_1_ECX_[24]; } // Time Stamp Counter Deadline
-    static bool AES(void)          { return CPU_Rep.f_1_ECX_[25]; } // AES Instruction Extensions
-    static bool XSAVE(void)        { return CPU_Rep.f_1_ECX_[26]; } // XSAVE/XSTOR States
-    static bool OSXSAVE(void)      { return CPU_Rep.f_1_ECX_[27]; } // OS-Enabled Extended State Management. XSETBV/XGETBV, XFEATURE_ENABLED_MASK (XCR0), XSAVE/XRSTOR.
-    static bool AVX(void)          { return CPU_Rep.f_1_ECX_[28]; } // Advanced Vector Extensions
-    static bool F16C(void)         { return CPU_Rep.f_1_ECX_[29]; } // 16-bit floating-point conversion instructions
-    static bool RDRAND(void)       { return CPU_Rep.f_1_ECX_[30]; } // RDRAND instruction
-    static bool HYPERVISOR(void)   { return CPU_Rep.f_1_ECX_[31]; } // Hypervisor present (always zero on physical CPUs).
+    static bool SSE3(void)         { return CPU_Rep().f_1_ECX_[0];  } // Streaming SIMD Extensions 3, XMM3, "pni"
+    static bool PCLMULQDQ(void)    { return CPU_Rep().f_1_ECX_[1];  } // PCLMULQDQ instruction
+    static bool DTES64(void)       { return CPU_Rep().f_1_ECX_[2];  } // 64-Bit Debug Store
+    static bool MONITOR(void)      { return CPU_Rep().f_1_ECX_[3];  } // Processor supports MONITOR and MWAIT instructions
+    static bool DS_CPL(void)       { return CPU_Rep().f_1_ECX_[4];  } // "ds_cpl" CPL Qualified (filtered) Debug Store
+    static bool VMX(void)          { return CPU_Rep().f_1_ECX_[5];  } // Virtual Machine Extensions. Processor supports Virtualization Technology.
+    static bool SMX(void)          { return CPU_Rep().f_1_ECX_[6];  } // Safer Mode Extensions. Processor supports  Trusted Execution Technology.
+    static bool EST(void)          { return CPU_Rep().f_1_ECX_[7];  } // Enhanced SpeedStep Technology. Has IA32_PERF_STS and IA32_PERF_CTL registers.
+    static bool TM2(void)          { return CPU_Rep().f_1_ECX_[8];  } // Thermal Monitor 2
+    static bool SSSE3(void)        { return CPU_Rep().f_1_ECX_[9];  } // Supplemental Streaming SIMD Extensions 3, "sse3", SSE-3.
+    static bool CNXT_ID(void)      { return CPU_Rep().f_1_ECX_[10]; } // L1 Context ID - L1 data cache mode is set to adaptive mode or shared in BIOS.
+    static bool SDBG(void)         { return CPU_Rep().f_1_ECX_[11]; } // Silicon Debug interface. IA32_DEBUG_INTERFACE
+    static bool FMA(void)          { return CPU_Rep().f_1_ECX_[12]; } // Fused Multiply Add. The processor supports FMA extensions using YMM state.
+    static bool CMPXCHG16B(void)   { return CPU_Rep().f_1_ECX_[13]; } // CMPXCHG16B instruction
+    static bool PCID(void)         { return CPU_Rep().f_1_ECX_[17]; } // Process Context Identifiers
+    static bool DCA(void)          { return CPU_Rep().f_1_ECX_[18]; } // Direct Cache Access. Processor supports data prefetch from memory mapped device.
+    static bool SSE41(void)        { return CPU_Rep().f_1_ECX_[19]; } // Streaming SIMD Extensions 4.1, "sse4_1", SSE-4.1.
+    static bool SSE42(void)        { return CPU_Rep().f_1_ECX_[20]; } // Streaming SIMD Extensions 4.2, "sse4_2", SSE-4.2.
+    static bool X2APIC(void)       { return CPU_Rep().f_1_ECX_[21]; } // Extended xAPIC Support
+    static bool MOVBE(void)        { return CPU_Rep().f_1_ECX_[22]; } // MOVBE instruction
+    static bool POPCNT(void)       { return CPU_Rep().f_1_ECX_[23]; } // POPCNT instruction
+    static bool TSC_DEADLINE(void) { return CPU_Rep().f_1_ECX_[24]; } // Time Stamp Counter Deadline
+    static bool AES(void)          { return CPU_Rep().f_1_ECX_[25]; } // AES Instruction Extensions
+    static bool XSAVE(void)        { return CPU_Rep().f_1_ECX_[26]; } // XSAVE/XSTOR States
+    static bool OSXSAVE(void)      { return CPU_Rep().f_1_ECX_[27]; } // OS-Enabled Extended State Management. XSETBV/XGETBV, XFEATURE_ENABLED_MASK (XCR0), XSAVE/XRSTOR.
+    static bool AVX(void)          { return CPU_Rep().f_1_ECX_[28]; } // Advanced Vector Extensions
+    static bool F16C(void)         { return CPU_Rep().f_1_ECX_[29]; } // 16-bit floating-point conversion instructions
+    static bool RDRAND(void)       { return CPU_Rep().f_1_ECX_[30]; } // RDRAND instruction
+    static bool HYPERVISOR(void)   { return CPU_Rep().f_1_ECX_[31]; } // Hypervisor present (always zero on physical CPUs).
 
     // ECX register
     // More extended AMD flags: CPUID level 0x80000001, ECX, word 6
 
-    static bool LAHF(void)           { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[0];  } // LAHF/SAHF in long mode
-    static bool CMP_LEGACY(void)     { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[1];  } // If yes HyperThreading not valid
-    static bool SVM(void)            { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[2];  } // Secure Virtual Machine
-    static bool EXTAPIC(void)        { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[3];  } // Extended APIC space
-    static bool CR8_LEGACY(void)     { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[4];  } // CR8 in 32-bit mode
-    static bool ABM(void)            { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[5];  } // Advanced bit manipulation
-    static bool SSE4a(void)          { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[6];  } // SSE-4A
-    static bool MISALIGNSSE(void)    { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[7];  } // AMD SSE mis-alignment sub-mode
-    static bool _3DNOWPREFETCH(void) { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[8];  } // 3DNow prefetch instructions
-    static bool OSVW(void)           { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[9];  } // OS Visible Workaround
-    static bool IBS(void)            { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[10]; } // Instruction Based Sampling
-    static bool XOP(void)            { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[11]; } // extended AVX instructions
-    static bool SKINIT(void)         { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[12]; } // SKINIT/STGI instructions
-    static bool WDT(void)            { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[13]; } // Watchdog timer
+    static bool LAHF(void)           { return                     CPU_Rep().f_81_ECX_[0];  } // LAHF/SAHF in long mode (Intel, too)
+    static bool CMP_LEGACY(void)     { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[1];  } // If yes HyperThreading not valid
+    static bool SVM(void)            { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[2];  } // Secure Virtual Machine
+    static bool EXTAPIC(void)        { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[3];  } // Extended APIC space
+    static bool CR8_LEGACY(void)     { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[4];  } // CR8 in 32-bit mode
+    static bool ABM(void)            { return                     CPU_Rep().f_81_ECX_[5];  } // Advanced bit manipulation, LZCNT (Intel, too)
+    static bool SSE4a(void)          { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[6];  } // SSE-4A
+    static bool MISALIGNSSE(void)    { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[7];  } // AMD SSE mis-alignment sub-mode
+    static bool _3DNOWPREFETCH(void) { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[8];  } // 3DNow prefetch instructions
+    static bool OSVW(void)           { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[9];  } // OS Visible Workaround
+    static bool IBS(void)            { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[10]; } // Instruction Based Sampling
+    static bool XOP(void)            { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[11]; } // extended AVX instructions
+    static bool SKINIT(void)         { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[12]; } // SKINIT/STGI instructions
+    static bool WDT(void)            { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[13]; } // Watchdog timer
                                                                     // reserved bit 14
-    static bool LWP(void)            { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[15]; } // Light Weight Profiling
-    static bool FMA4(void)           { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[16]; } // 4 operands MAC instructions
-    static bool TCE(void)            { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[17]; } // Translation Cache Extension
+    static bool LWP(void)            { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[15]; } // Light Weight Profiling
+    static bool FMA4(void)           { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[16]; } // 4 operands MAC instructions
+    static bool TCE(void)            { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[17]; } // Translation Cache Extension
                                                                     // reserved bit 18
-    static bool NODEID_MSR(void)     { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[19]; } // NodeId MSR
+    static bool NODEID_MSR(void)     { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[19]; } // NodeId MSR
                                                                     // reserved bit 20
-    static bool TBM(void)            { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[21]; } // AMD. Trailing Bit Manipulation, complements BMI1.
-    static bool TOPOEXT(void)        { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[22]; } // Topology extensions CPUID leafs
-    static bool PERFCTR_CORE(void)   { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[23]; } // Core performance counter extensions
-    static bool PERFCTR_NB(void)     { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[24]; } // NB performance counter extensions
-    static bool BPEXT(void)          { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[26]; } // Data breakpoint extension
-    static bool PTSC(void)           { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[27]; } // Performance time-stamp counter
-    static bool PERFCTR_LLC(void)    { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[28]; } // Last Level Cache performance counter extensions
-    static bool MWAITX(void)         { return CPU_Rep.isAMD_   && CPU_Rep.f_81_ECX_[29]; } // MWAIT extension (MONITORX/MWAITX instructions)
+    static bool TBM(void)            { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[21]; } // AMD. Trailing Bit Manipulation, complements BMI1.
+    static bool TOPOEXT(void)        { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[22]; } // Topology extensions CPUID leafs
+    static bool PERFCTR_CORE(void)   { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[23]; } // Core performance counter extensions
+    static bool PERFCTR_NB(void)     { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[24]; } // NB performance counter extensions
+    static bool BPEXT(void)          { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[26]; } // Data breakpoint extension
+    static bool PTSC(void)           { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[27]; } // Performance time-stamp counter
+    static bool PERFCTR_LLC(void)    { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[28]; } // Last Level Cache performance counter extensions
+    static bool MWAITX(void)         { return CPU_Rep().isAMD_   && CPU_Rep().f_81_ECX_[29]; } // MWAIT extension (MONITORX/MWAITX instructions)
 
     // Intel-defined CPU features, CPUID level 0x00000007:0 (EBX), word 9
 
-    static bool FSGSBASE(void)        { return                     CPU_Rep.f_7_EBX_[0];  } // RDFSBASE, WRFSBASE, RDGSBASE, WRGSBASE instructions
-    static bool TSC_ADJUST(void)      { return                     CPU_Rep.f_7_EBX_[1];  } // TSC adjustment MSR 0x3B, IA32_TSC_ADJUST
-    static bool SGX(void)             { return CPU_Rep.isIntel_ && CPU_Rep.f_7_EBX_[2];  } // Supports Intel® Software Guard Extensions (Intel® SGX Extensions)
-    static bool BMI1(void)            { return                     CPU_Rep.f_7_EBX_[3];  } // 1st group bit manipulation extensions
-    static bool HLE(void)             { return CPU_Rep.isIntel_ && CPU_Rep.f_7_EBX_[4];  } // Hardware Lock Elision (HLE, non-TSX)
-    static bool AVX2(void)            { return                     CPU_Rep.f_7_EBX_[5];  } // AVX2 instructions
-    static bool FDP_EXCPTN_ONLY(void) { return                     CPU_Rep.f_7_EBX_[6];  } // x87 FPU Data Pointer updated only on x87 exceptions if 1.
-    static bool SMEP(void)            { return                     CPU_Rep.f_7_EBX_[7];  } // Supervisor Mode Execution Protection
-    static bool BMI2(void)            { return                     CPU_Rep.f_7_EBX_[8];  } // 2nd group bit manipulation extensions
-    static bool ERMS(void)            { return                     CPU_Rep.f_7_EBX_[9];  } // Enhanced REP MOVSB/STOSB instructions
-    static bool INVPCID(void)         { return                     CPU_Rep.f_7_EBX_[10]; } // Invalidate Processor Context ID
-    static bool RTM(void)             { return CPU_Rep.isIntel_ && CPU_Rep.f_7_EBX_[11]; } // Restricted Transactional Memory (RTM)
-    static bool CQM(void)             { return                     CPU_Rep.f_7_EBX_[12]; } // Cache QoS Monitoring, PQM?
-    static bool FPU_CSDS(void)        { return                     CPU_Rep.f_7_EBX_[13]; } // Zero out FPU CS and FPU DS
-    static bool MPX(void)             { return                     CPU_Rep.f_7_EBX_[14]; } // Memory Protection Extension
-    static bool RDT_A(void)           { return                     CPU_Rep.f_7_EBX_[15]; } // Resource Director Technology Allocation, PQE?
-    static bool AVX512F(void)         { return                     CPU_Rep.f_7_EBX_[16]; } // AVX-512 Foundation
-    static bool AVX512DQ(void)        { return                     CPU_Rep.f_7_EBX_[17]; } // AVX-512 DQ (Double/Quad granular) Instructions
-    static bool RDSEED(void)          { return                     CPU_Rep.f_7_EBX_[18]; } // RDSEED instruction
-    static bool ADX(void)             { return                     CPU_Rep.f_7_EBX_[19]; } // ADCX and ADOX instructions
-    static bool SMAP(void)            { return                     CPU_Rep.f_7_EBX_[20]; } // Supervisor Mode Access Prevention
-    static bool AVX512IFMA(void)      { return                     CPU_Rep.f_7_EBX_[21]; } // AVX-512 Integer Fused Multiply-Add instructions
-    static bool PCOMMIT(void)         { return                     CPU_Rep.f_7_EBX_[22]; } // PCOMMIT instruction
-    static bool CLFLUSHOPT(void)      { return                     CPU_Rep.f_7_EBX_[23]; } // CLFLUSHOPT instruction
-    static bool CLWB(void)            { return                     CPU_Rep.f_7_EBX_[24]; } // CLWB instruction
-    static bool IPT(void)             { return CPU_Rep.isIntel_ && CPU_Rep.f_7_EBX_[25]; } // Intel Processor Trace
-    static bool AVX512PF(void)        { return                     CPU_Rep.f_7_EBX_[26]; } // AVX-512 Prefetch
-    static bool AVX512ER(void)        { return                     CPU_Rep.f_7_EBX_[27]; } // AVX-512 Exponential and Reciprocal
-    static bool AVX512CD(void)        { return                     CPU_Rep.f_7_EBX_[28]; } // AVX-512 Conflict Detection
-    static bool SHA(void)             { return                     CPU_Rep.f_7_EBX_[29]; } // SHA1/SHA256 Instruction Extensions
-    static bool AVX512BW(void)        { return                     CPU_Rep.f_7_EBX_[30]; } // AVX-512 BW (Byte/Word granular) Instructions
-    static bool AVX512VL(void)        { return                     CPU_Rep.f_7_EBX_[31]; } // AVX-512 VL (128/256 Vector Length) Extensions
+    static bool FSGSBASE(void)        { return                     CPU_Rep().f_7_EBX_[0];  } // RDFSBASE, WRFSBASE, RDGSBASE, WRGSBASE instructions
+    static bool TSC_ADJUST(void)      { return                     CPU_Rep().f_7_EBX_[1];  } // TSC adjustment MSR 0x3B, IA32_TSC_ADJUST
+    static bool SGX(void)             { return CPU_Rep().isIntel_ && CPU_Rep().f_7_EBX_[2];  } // Supports Intel® Software Guard Extensions (Intel® SGX Extensions)
+    static bool BMI1(void)            { return                     CPU_Rep().f_7_EBX_[3];  } // 1st group bit manipulation extensions
+    static bool HLE(void)             { return CPU_Rep().isIntel_ && CPU_Rep().f_7_EBX_[4];  } // Hardware Lock Elision (HLE, non-TSX)
+    static bool AVX2(void)            { return                     CPU_Rep().f_7_EBX_[5];  } // AVX2 instructions
+    static bool FDP_EXCPTN_ONLY(void) { return                     CPU_Rep().f_7_EBX_[6];  } // x87 FPU Data Pointer updated only on x87 exceptions if 1.
+    static bool SMEP(void)            { return                     CPU_Rep().f_7_EBX_[7];  } // Supervisor Mode Execution Protection
+    static bool BMI2(void)            { return                     CPU_Rep().f_7_EBX_[8];  } // 2nd group bit manipulation extensions
+    static bool ERMS(void)            { return                     CPU_Rep().f_7_EBX_[9];  } // Enhanced REP MOVSB/STOSB instructions
+    static bool INVPCID(void)         { return                     CPU_Rep().f_7_EBX_[10]; } // Invalidate Processor Context ID
+    static bool RTM(void)             { return CPU_Rep().isIntel_ && CPU_Rep().f_7_EBX_[11]; } // Restricted Transactional Memory (RTM)
+    static bool CQM(void)             { return                     CPU_Rep().f_7_EBX_[12]; } // Cache QoS Monitoring, PQM?
+    static bool FPU_CSDS(void)        { return                     CPU_Rep().f_7_EBX_[13]; } // Zero out FPU CS and FPU DS
+    static bool MPX(void)             { return                     CPU_Rep().f_7_EBX_[14]; } // Memory Protection Extension
+    static bool RDT_A(void)           { return                     CPU_Rep().f_7_EBX_[15]; } // Resource Director Technology Allocation, PQE?
+    static bool AVX512F(void)         { return                     CPU_Rep().f_7_EBX_[16]; } // AVX-512 Foundation
+    static bool AVX512DQ(void)        { return                     CPU_Rep().f_7_EBX_[17]; } // AVX-512 DQ (Double/Quad granular) Instructions
+    static bool RDSEED(void)          { return                     CPU_Rep().f_7_EBX_[18]; } // RDSEED instruction
+    static bool ADX(void)             { return                     CPU_Rep().f_7_EBX_[19]; } // ADCX and ADOX instructions
+    static bool SMAP(void)            { return                     CPU_Rep().f_7_EBX_[20]; } // Supervisor Mode Access Prevention
+    static bool AVX512IFMA(void)      { return                     CPU_Rep().f_7_EBX_[21]; } // AVX-512 Integer Fused Multiply-Add instructions
+    static bool PCOMMIT(void)         { return                     CPU_Rep().f_7_EBX_[22]; } // PCOMMIT instruction
+    static bool CLFLUSHOPT(void)      { return                     CPU_Rep().f_7_EBX_[23]; } // CLFLUSHOPT instruction
+    static bool CLWB(void)            { return                     CPU_Rep().f_7_EBX_[24]; } // CLWB instruction
+    static bool IPT(void)             { return CPU_Rep().isIntel_ && CPU_Rep().f_7_EBX_[25]; } // Intel Processor Trace
+    static bool AVX512PF(void)        { return                     CPU_Rep().f_7_EBX_[26]; } // AVX-512 Prefetch
+    static bool AVX512ER(void)        { return                     CPU_Rep().f_7_EBX_[27]; } // AVX-512 Exponential and Reciprocal
+    static bool AVX512CD(void)        { return                     CPU_Rep().f_7_EBX_[28]; } // AVX-512 Conflict Detection
+    static bool SHA(void)             { return                     CPU_Rep().f_7_EBX_[29]; } // SHA1/SHA256 Instruction Extensions
+    static bool AVX512BW(void)        { return                     CPU_Rep().f_7_EBX_[30]; } // AVX-512 BW (Byte/Word granular) Instructions
+    static bool AVX512VL(void)        { return                     CPU_Rep().f_7_EBX_[31]; } // AVX-512 VL (128/256 Vector Length) Extensions
 
     // EAX=7 ECX=0 -> ECX
     // Intel-defined CPU features, CPUID level 0x00000007:0 (ECX), word 16
 
-    static bool PREFETCHWT1(void)        { return CPU_Rep.f_7_ECX_[0];  } // PREFETCHWT instruction
-    static bool AVX512_VBMI(void)        { return CPU_Rep.f_7_ECX_[1];  } // AVX512 Vector Bit Manipulation instructions
-    static bool UMIP(void)               { return CPU_Rep.f_7_ECX_[2];  } // User Mode Instruction Protection
-    static bool PKU(void)                { return CPU_Rep.f_7_ECX_[3];  } // Protection Keys for Userspace
-    static bool OSPKE(void)              { return CPU_Rep.f_7_ECX_[4];  } // OS Protection Keys Enable
-    static bool WAITPKG(void)            { return CPU_Rep.f_7_ECX_[5];  } // UMONITOR/UMWAIT/TPAUSE Instructions
-    static bool AVX512_VBMI2(void)       { return CPU_Rep.f_7_ECX_[6];  } // Additional AVX512 Vector Bit Manipulation Instructions
-    static bool CET_SS(void)             { return CPU_Rep.f_7_ECX_[7];  } // CET shadow stack features
-    static bool GFNI(void)               { return CPU_Rep.f_7_ECX_[8];  } // Galois Field New Instructions
-    static bool VAES(void)               { return CPU_Rep.f_7_ECX_[9];  } // Vector AES
-    static bool VPCLMULQDQ(void)         { return CPU_Rep.f_7_ECX_[10]; } // Carry-Less Multiplication Double Quadword
-    static bool AVX512_VNNI(void)        { return CPU_Rep.f_7_ECX_[11]; } // AVX512 Vector Neural Network Instructions
-    static bool AVX512_BITALG(void)      { return CPU_Rep.f_7_ECX_[12]; } // AVX512 Support for VPOPCNT[B,W] and VPSHUF-BITQMB instructions
-    static bool TME(void)                { return CPU_Rep.f_7_ECX_[12]; } // Intel Total Memory Encryption
-    static bool AVX512_VPOPCNTDQ(void)   { return CPU_Rep.f_7_ECX_[14]; } // POPCNT for vectors of DW/QW
+    static bool PREFETCHWT1(void)        { return CPU_Rep().f_7_ECX_[0];  } // PREFETCHWT instruction
+    static bool AVX512_VBMI(void)        { return CPU_Rep().f_7_ECX_[1];  } // AVX512 Vector Bit Manipulation instructions
+    static bool UMIP(void)               { return CPU_Rep().f_7_ECX_[2];  } // User Mode Instruction Protection
+    static bool PKU(void)                { return CPU_Rep().f_7_ECX_[3];  } // Protection Keys for Userspace
+    static bool OSPKE(void)              { return CPU_Rep().f_7_ECX_[4];  } // OS Protection Keys Enable
+    static bool WAITPKG(void)            { return CPU_Rep().f_7_ECX_[5];  } // UMONITOR/UMWAIT/TPAUSE Instructions
+    static bool AVX512_VBMI2(void)       { return CPU_Rep().f_7_ECX_[6];  } // Additional AVX512 Vector Bit Manipulation Instructions
+    static bool CET_SS(void)             { return CPU_Rep().f_7_ECX_[7];  } // CET shadow stack features
+    static bool GFNI(void)               { return CPU_Rep().f_7_ECX_[8];  } // Galois Field New Instructions
+    static bool VAES(void)               { return CPU_Rep().f_7_ECX_[9];  } // Vector AES
+    static bool VPCLMULQDQ(void)         { return CPU_Rep().f_7_ECX_[10]; } // Carry-Less Multiplication Double Quadword
+    static bool AVX512_VNNI(void)        { return CPU_Rep().f_7_ECX_[11]; } // AVX512 Vector Neural Network Instructions
+    static bool AVX512_BITALG(void)      { return CPU_Rep().f_7_ECX_[12]; } // AVX512 Support for VPOPCNT[B,W] and VPSHUF-BITQMB instructions
+    static bool TME(void)                { return CPU_Rep().f_7_ECX_[12]; } // Intel Total Memory Encryption
+    static bool AVX512_VPOPCNTDQ(void)   { return CPU_Rep().f_7_ECX_[14]; } // POPCNT for vectors of DW/QW
                                                    // reserved bit 15
-    static bool FIVE_LEVEL_PAGING(void)  { return CPU_Rep.f_7_ECX_[16]; } // 57-bit linear addresses and five-level paging
+    static bool FIVE_LEVEL_PAGING(void)  { return CPU_Rep().f_7_ECX_[16]; } // 57-bit linear addresses and five-level paging
                   // 17-21 MAWAU: value of MAWAU used by the BNDLDX and BNDSTX instructions in 64-bit mode
-    static bool RDPID(void)              { return CPU_Rep.f_7_ECX_[22]; } // RDPID instruction
-    static bool KL(void)                 { return CPU_Rep.f_7_ECX_[23]; } // Key Locker
-    static bool BUS_LOCK_DETECT(void)    { return CPU_Rep.f_7_ECX_[24]; } // OS bus-lock detection
-    static bool CLDEMOTE(void)           { return CPU_Rep.f_7_ECX_[25]; } // CLDEMOTE instruction
+    static bool RDPID(void)              { return CPU_Rep().f_7_ECX_[22]; } // RDPID instruction
+    static bool KL(void)                 { return CPU_Rep().f_7_ECX_[23]; } // Key Locker
+    static bool BUS_LOCK_DETECT(void)    { return CPU_Rep().f_7_ECX_[24]; } // OS bus-lock detection
+    static bool CLDEMOTE(void)           { return CPU_Rep().f_7_ECX_[25]; } // CLDEMOTE instruction
                                                    // reserved bit 26
-    static bool MOVDIRI(void)            { return CPU_Rep.f_7_ECX_[27]; } // MOVDIRI instruction
-    static bool MOVDIR64B(void)          { return CPU_Rep.f_7_ECX_[28]; } // MOVDIR64B instruction
-    static bool ENQCMD(void)             { return CPU_Rep.f_7_ECX_[29]; } // ENQCMD and ENQCMDS instructions
-    static bool SGX_LC(void)             { return CPU_Rep.f_7_ECX_[30]; } // Software Guard Extensions Launch Control
-    static bool PKS(void)                { return CPU_Rep.f_7_ECX_[31]; } // protection keys for supervisor-mode pages
+    static bool MOVDIRI(void)            { return CPU_Rep().f_7_ECX_[27]; } // MOVDIRI instruction
+    static bool MOVDIR64B(void)          { return CPU_Rep().f_7_ECX_[28]; } // MOVDIR64B instruction
+    static bool ENQCMD(void)             { return CPU_Rep().f_7_ECX_[29]; } // ENQCMD and ENQCMDS instructions
+    static bool SGX_LC(void)             { return CPU_Rep().f_7_ECX_[30]; } // Software Guard Extensions Launch Control
+    static bool PKS(void)                { return CPU_Rep().f_7_ECX_[31]; } // protection keys for supervisor-mode pages
+
+    // EAX=7 ECX=0 -> EDX
+    // Intel-defined CPU features, CPUID level 0x00000007:0 (EDX), word 18
+
+    static bool AVX512_4VNNIW(void)       { return CPU_Rep().f_7_EDX_[2];  } // AVX-512 Neural Network Instructions
+    static bool AVX512_4FMAPS(void)       { return CPU_Rep().f_7_EDX_[3];  } // AVX-512 Multiply Accumulation Single precision
+    static bool FSRM(void)                { return CPU_Rep().f_7_EDX_[4];  } // Fast Short REP MOV
+    static bool AVX512_VP2INTERSECT(void) { return CPU_Rep().f_7_EDX_[8];  } // AVX-512 Intersect for D/Q
+    static bool SRBDS_CTRL(void)          { return CPU_Rep().f_7_EDX_[9];  } // SRBDS mitigation MSR available
+    static bool MD_CLEAR(void)            { return CPU_Rep().f_7_EDX_[10]; } // VERW clears CPU buffers (MDS mitigation)
+    static bool RTM_ALWAYS_ABORT(void)    { return CPU_Rep().f_7_EDX_[11]; } // RTM transaction always aborts
+    static bool TSX_FORCE_ABORT(void)     { return CPU_Rep().f_7_EDX_[13]; } // TSX_FORCE_ABORT MSR
+    static bool SERIALIZE(void)           { return CPU_Rep().f_7_EDX_[14]; } // SERIALIZE instruction
+    static bool HYBRID_CPU(void)          { return CPU_Rep().f_7_EDX_[15]; } // This part has CPUs of more than one type
+    static bool TSXLDTRK(void)            { return CPU_Rep().f_7_EDX_[16]; } // TSX Suspend Load Address Tracking
+    static bool PCONFIG(void)             { return CPU_Rep().f_7_EDX_[18]; } // Intel PCONFIG
+    static bool ARCH_LBR(void)            { return CPU_Rep().f_7_EDX_[19]; } // Intel ARCH LBR
+    static bool IBT(void)                 { return CPU_Rep().f_7_EDX_[20]; } // CET Indirect Branch Tracking
+    static bool AMX_BF16(void)            { return CPU_Rep().f_7_EDX_[22]; } // AMX bf16 Support
+    static bool AVX512_FP16(void)         { return CPU_Rep().f_7_EDX_[23]; } // AVX512 FP16
+    static bool AMX_TILE(void)            { return CPU_Rep().f_7_EDX_[24]; } // AMX tile Support
+    static bool AMX_INT8(void)            { return CPU_Rep().f_7_EDX_[25]; } // AMX int8 Support
+    static bool IBRS_IBPB(void)           { return CPU_Rep().f_7_EDX_[26]; } // "spec_ctrl" Speculation Control (IBRS + IBPB)
+    static bool STIBP(void)               { return CPU_Rep().f_7_EDX_[27]; } // Single Thread Indirect Branch Predictors
+    static bool L1D_FLUSH(void)           { return CPU_Rep().f_7_EDX_[28]; } // Flush L1D cache (L1TF mitigation)
+    static bool ARCH_CAPABILITIES(void)   { return CPU_Rep().f_7_EDX_[29]; } // IA32_ARCH_CAPABILITIES MSR (Intel)
+    static bool CORE_CAPABILITIES(void)   { return CPU_Rep().f_7_EDX_[30]; } // IA32_CORE_CAPABILITIES MSR
+    static bool SSBD(void)                { return CPU_Rep().f_7_EDX_[31]; } // "spec_ctrl_ssbd" Speculative Store Bypass Disable
+
+    // EBX register
+    // AMD-defined CPU features, CPUID level 0x80000008 (EBX), word 13
+
+    static bool AMD_IBPB(void)      { return CPU_Rep().isAMD_ && CPU_Ext().f_88_EBX_[12]; } // Indirect Branch Prediction Barrier
+    static bool AMD_IBRS(void)      { return CPU_Rep().isAMD_ && CPU_Ext().f_88_EBX_[14]; } // Indirect Branch Restricted Speculation
+    static bool AMD_STIBP(void)     { return CPU_Rep().isAMD_ && CPU_Ext().f_88_EBX_[15]; } // Single Thread Indirect Branch Predictors
+    static bool AMD_SSBD(void)      { return CPU_Rep().isAMD_ && CPU_Ext().f_88_EBX_[24]; } // Speculative Store Bypass Disable
+    static bool AMD_VIRT_SSBD(void) { return CPU_Rep().isAMD_ && CPU_Ext().f_88_EBX_[25]; } // Virtualized Speculative Store Bypass Disable
 
 private:
-    static const InstructionSet_Internal CPU_Rep;
+    class InstructionSet_Internal;
+    class InstructionSet_Extended;
+
+    // CPUID is queried on first use, not by a static initializer before main().
+    // CPUID traps in virtual machines (several microseconds per leaf), so "cpuinfo exec"
+    // only queries the feature leaves, the brand string and leaf 0x80000008 are separate.
+    static const InstructionSet_Internal& CPU_Rep(void) { static const InstructionSet_Internal rep; return rep; }
+    static const InstructionSet_Extended& CPU_Ext(void) { static const InstructionSet_Extended ext; return ext; }
+
+#ifdef _WIN32
+    typedef std::array<int, 4> Registers;
+#else
+    typedef std::array<unsigned int, 4> Registers;
+#endif
+
+    static Registers cpuid(unsigned int leaf)
+    {
+        Registers cpui{};
+#if _WIN32 || WIN32
+        __cpuidex(cpui.data(), static_cast<int>(leaf), 0);
+#elif defined(__i386__) || defined(__x86_64__)
+        __cpuid_count(leaf, 0, cpui[0], cpui[1], cpui[2], cpui[3]);
+#else
+        (void) leaf; // no CPUID on other architectures, all flags stay false
+#endif
+        return cpui;
+    }
+
+    // only valid, if OSXSAVE is set
+    static unsigned long long xgetbv0(void)
+    {
+#if _WIN32 || WIN32
+        return _xgetbv(0);
+#elif defined(__i386__) || defined(__x86_64__)
+        unsigned int eax = 0;
+        unsigned int edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<unsigned long long>(edx) << 32) | eax;
+#else
+        return 0;
+#endif
+    }
 
+    // leaves 0x0, 0x1, 0x7, 0x80000000 and 0x80000001
     class InstructionSet_Internal
     {
     public:
@@ -230,43 +336,22 @@ private:
             f_1_EDX_{ 0 },
             f_7_EBX_{ 0 },
             f_7_ECX_{ 0 },
+            f_7_EDX_{ 0 },
             f_81_ECX_{ 0 },
             f_81_EDX_{ 0 },
-            data_{},
-            extdata_{}
+            xcr0_{ 0 }
         {
-#ifdef _WIN32
-            std::array<int, 4> cpui;
-#else
-            std::array<unsigned int, 4> cpui;
-#endif
-
             // Calling __cpuid with 0x0 as the function_id argument
-            // gets the number of the highest valid function ID.
-#ifdef _WIN32
-            __cpuid(cpui.data(), 0);
-#else
-            cpui[0] = __get_cpuid_max(0, &cpui[1]);
-#endif
-            nIds_ = cpui[0];
-
-            for (int i = 0; i <= nIds_; ++i)
-            {
-#ifdef _WIN32
-                __cpuidex(cpui.data(), i, 0);
-#else
-                __cpuid_count(i, 0, cpui[0], cpui[1], cpui[2], cpui[3]);
-#endif
-
-                data_.push_back(cpui);
-            }
+            // gets the number of the highest valid function ID and the vendor.
+            const Registers leaf0 = cpuid(0);
+            nIds_ = static_cast<int>(leaf0[0]);
 
             // Capture vendor string
             char vendor[0x20];
             memset(vendor, 0, sizeof(vendor));
-            *reinterpret_cast<int*>(vendor + 0) = data_[0][1];
-            *reinterpret_cast<int*>(vendor + 4) = data_[0][3];
-            *reinterpret_cast<int*>(vendor + 8) = data_[0][2];
+            memcpy(vendor + 0, &leaf0[1], 4);
+            memcpy(vendor + 4, &leaf0[3], 4);
+            memcpy(vendor + 8, &leaf0[2], 4);
             vendor_ = vendor;
             if (vendor_ == "GenuineIntel")
             {
@@ -280,80 +365,87 @@ private:
             // load bitset with flags for function 0x00000001
             if (nIds_ >= 1)
             {
-                f_1_ECX_ = data_[1][2];
-                f_1_EDX_ = data_[1][3];
+                const Registers leaf1 = cpuid(1);
+                f_1_ECX_ = leaf1[2];
+                f_1_EDX_ = leaf1[3];
+            }
+
+            // XGETBV faults, unless the OS has enabled it (OSXSAVE)
+            if (f_1_ECX_[27])
+            {
+                xcr0_ = xgetbv0();
             }
 
             // load bitset with flags for function 0x00000007
             if (nIds_ >= 7)
             {
-                f_7_EBX_ = data_[7][1];
-                f_7_ECX_ = data_[7][2];
+                const Registers leaf7 = cpuid(7);
+                f_7_EBX_ = leaf7[1];
+                f_7_ECX_ = leaf7[2];
+                f_7_EDX_ = leaf7[3];
             }
 
             // Calling __cpuid with 0x80000000 as the function_id argument
             // gets the number of the highest valid extended ID.
-#ifdef _WIN32
-            __cpuid(cpui.data(), 0x80000000);
-#else
-            __cpuid(0x80000000, cpui[0], cpui[1], cpui[2], cpui[3]);
-#endif
-            nExIds_ = cpui[0];
-
-            char brand[0x40];
-            memset(brand, 0, sizeof(brand));
-
-            for (int i = 0x80000000; i <= nExIds_; ++i)
-            {
-#ifdef _WIN32
-                __cpuidex(cpui.data(), i, 0);
-#else
-                __cpuid_count(i, 0, cpui[0], cpui[1], cpui[2], cpui[3]);
-#endif
-                extdata_.push_back(cpui);
-            }
+            nExIds_ = static_cast<int>(cpuid(0x80000000)[0]);
 
             // load bitset with flags for function 0x80000001
-            if (nExIds_ >= 0x80000001)
-            {
-                f_81_ECX_ = extdata_[1][2];
-                f_81_EDX_ = extdata_[1][3];
-            }
-
-            // Interpret CPU brand string if reported
-            if (nExIds_ >= 0x80000004)
+            if (static_cast<unsigned int>(nExIds_) >= 0x80000001)
             {
-                memcpy(brand +  0, extdata_[2].data(), sizeof(cpui));
-                memcpy(brand + 16, extdata_[3].data(), sizeof(cpui));
-                memcpy(brand + 32, extdata_[4].data(), sizeof(cpui));
-                brand_ = brand;
+                const Registers leaf81 = cpuid(0x80000001);
+                f_81_ECX_ = leaf81[2];
+                f_81_EDX_ = leaf81[3];
             }
         };
 
         int nIds_;
         int nExIds_;
         std::string vendor_;
-        std::string brand_;
         bool isIntel_;
         bool isAMD_;
         std::bitset<32> f_1_ECX_;
         std::bitset<32> f_1_EDX_;
         std::bitset<32> f_7_EBX_;
         std::bitset<32> f_7_ECX_;
+        std::bitset<32> f_7_EDX_;
         std::bitset<32> f_81_ECX_;
         std::bitset<32> f_81_EDX_;
-#ifdef _WIN32
-        std::vector<std::array<int, 4>> data_;
-        std::vector<std::array<int, 4>> extdata_;
-#else
-        std::vector<std::array<unsigned int, 4>> data_;
-        std::vector<std::array<unsigned int, 4>> extdata_;
-#endif
+        unsigned long long xcr0_;
     };
-};
 
-// Initialize static member data
-const InstructionSet::InstructionSet_Internal InstructionSet::CPU_Rep;
+    // leaves 0x80000002 to 0x80000004 (brand string) and 0x80000008
+    class InstructionSet_Extended
+    {
+    public:
+        InstructionSet_Extended()
+            : f_88_EBX_{ 0 }
+        {
+            const unsigned int nExIds = static_cast<unsigned int>(CPU_Rep().nExIds_);
+
+            // load bitset with flags for function 0x80000008
+            if (nExIds >= 0x80000008)
+            {
+                f_88_EBX_ = cpuid(0x80000008)[1];
+            }
+
+            // Interpret CPU brand string if reported
+            if (nExIds >= 0x80000004)
+            {
+                char brand[0x40];
+                memset(brand, 0, sizeof(brand));
+                for (unsigned int i = 0; i < 3; ++i)
+                {
+                    const Registers part = cpuid(0x80000002 + i);
+                    memcpy(brand + 16 * i, part.data(), sizeof(part));
+                }
+                brand_ = brand;
+            }
+        };
+
+        std::string brand_;
+        std::bitset<32> f_88_EBX_;
+    };
+};
 
 inline std::string trim(std::string& str)
 {
@@ -361,6 +453,14 @@ inline std::string trim(std::string& str)
     str.erase(0, str.find_first_not_of(' ')); // left-trim
     return str;
 }
+inline std::string trim_whitespace(const std::string& str)
+{
+    std::string::size_type first = 0;
+    std::string::size_type last  = str.size();
+    while (first < last && std::isspace(static_cast<unsigned char>(str[first])))    { ++first; }
+    while (last > first && std::isspace(static_cast<unsigned char>(str[last - 1]))) { --last;  }
+    return str.substr(first, last - first);
+}
 inline std::string rm_last_char(std::string& str, const std::string& c)
 {
     return str.substr(0, str.find_last_of(c));
@@ -372,14 +472,232 @@ inline std::string getYear()
     ss << std::put_time(std::localtime(&time), "%Y");
     return ss.str();
 }
+inline std::string json_sanitize(const std::string& str)
+{
+    // drop quotes, backslashes and control chars, so that the value is a valid json string.
+    // 92 is the backslash: a backslash char literal does not survive escaper.cpp,
+    // when this source is embedded into CPUINFO.cmake. Keep the number.
+    std::string result;
+    for (char c : str) {
+        if (c == '"' || c == 92 || static_cast<unsigned char>(c) < 0x20) { continue; }
+        result += c;
+    }
+    return result;
+}
+inline std::string format_ns(double ns)
+{
+    // whole nanoseconds, CMake would print fractions with full double precision
+    if (ns < 0) { return "null"; }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(0) << ns;
+    return ss.str();
+}
 
-int main()
+/**
+ * Reads the kernel's speculative-execution vulnerability and mitigation state,
+ * one entry per file in <root>/sys/devices/system/cpu/vulnerabilities, sorted by name.
+ * Returns an empty list on non-Linux systems or kernels without this directory.
+ */
+std::vector<std::pair<std::string, std::string>> getVulnerabilities(const std::string& root)
 {
-    std::ostringstream outstream;
+    std::vector<std::pair<std::string, std::string>> vulnerabilities;
+#if defined(__linux__)
+    const std::string path = root + "/sys/devices/system/cpu/vulnerabilities/";
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) { return vulnerabilities; }
 
-    // print the json key value pair
-    auto print_pair = [&outstream](std::string key, auto val) {
-        outstream << "    \"" << key << "\": " << std::boolalpha << val << ",\n";
+    while (struct dirent* entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name.empty() || name[0] == '.') { continue; }
+
+        std::ifstream file(path + name);
+        std::string state;
+        std::getline(file, state);
+        vulnerabilities.emplace_back(json_sanitize(name), json_sanitize(state));
+    }
+    closedir(dir);
+
+    std::sort(vulnerabilities.begin(), vulnerabilities.end());
+#endif
+    return vulnerabilities;
+}
+
+/**
+ * Measures the round-trip of a trivial syscall (getppid), which is what
+ * KPTI, retpolines and buffer clearing on kernel exit make more expensive.
+ * Returns the best average of 5 runs in nanoseconds, or -1 if not measured.
+ */
+double measureSyscallNs()
+{
+#if defined(__linux__)
+    const int runs = 5;
+    const int iterations = 100000;
+    double best = -1;
+
+    for (int run = 0; run < runs; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            syscall(SYS_getppid);
+        }
+        auto stop = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+        if (best < 0 || ns < best) { best = ns; }
+    }
+    return best;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Measures the cost of a context switch by passing a token between two processes
+ * through a pair of pipes (lmbench lat_ctx style). Both processes are pinned onto
+ * the same cpu, so that every hand-over is a real switch. The pipe read/write
+ * syscalls are included in the result.
+ * Returns nanoseconds per switch, or -1 if not measured. Without pinning, the
+ * processes could run on different cpus and the result would be the cross-cpu
+ * wake-up latency, so that is reported as not measured, too.
+ */
+double measureContextSwitchNs()
+{
+#if defined(__linux__)
+    const int iterations = 10000;
+
+    // pin both processes to the current cpu (sched_getcpu() fails with -1)
+    cpu_set_t old_mask;
+    const int cpu = sched_getcpu();
+    if (cpu < 0 || sched_getaffinity(0, sizeof(old_mask), &old_mask) != 0) { return -1; }
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) { return -1; }
+
+    int ping[2];
+    int pong[2];
+    if (pipe(ping) != 0)
+    {
+        sched_setaffinity(0, sizeof(old_mask), &old_mask);
+        return -1;
+    }
+    if (pipe(pong) != 0)
+    {
+        close(ping[0]);
+        close(ping[1]);
+        sched_setaffinity(0, sizeof(old_mask), &old_mask);
+        return -1;
+    }
+
+    char token = 0;
+    pid_t child = fork();
+    if (child == 0)
+    {
+        // child: echo every token back, until the parent closes its end
+        close(ping[1]);
+        close(pong[0]);
+        while (read(ping[0], &token, 1) == 1 && write(pong[1], &token, 1) == 1) {}
+        _exit(0);
+    }
+
+    close(ping[0]);
+    close(pong[1]);
+
+    int i = 0;
+    auto start = std::chrono::steady_clock::now();
+    if (child > 0)
+    {
+        for (; i < iterations; ++i) {
+            if (write(ping[1], &token, 1) != 1 || read(pong[0], &token, 1) != 1) { break; }
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    close(ping[1]);
+    close(pong[0]);
+    if (child > 0) { waitpid(child, nullptr, 0); }
+    sched_setaffinity(0, sizeof(old_mask), &old_mask);
+
+    if (i != iterations) { return -1; }
+
+    // every round trip consists of two context switches
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (2.0 * iterations);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * The OS must enable the register state in XCR0, before AVX or AVX-512 instructions can be used,
+ * even if CPUID reports them (e.g. a hypervisor may hide the state):
+ * bits 1-2 (XMM, YMM) for AVX, additionally bits 5-7 (opmask, ZMM_Hi256, Hi16_ZMM) for AVX-512.
+ */
+inline bool isAvxStateEnabled(unsigned long long xcr0)    { return (xcr0 & 0x6) == 0x6; }
+inline bool isAvx512StateEnabled(unsigned long long xcr0) { return (xcr0 & 0xE6) == 0xE6; }
+
+/**
+ * Determines the x86-64 micro-architecture level of the host, as defined by the x86-64 psABI.
+ * The CPUID feature bits are combined with the given XCR0, the overload without argument reads it.
+ * Returns 1 to 4, or 0 if not even the x86-64 baseline (v1) is supported.
+ */
+int getArchitectureLevel(unsigned long long xcr0)
+{
+    const bool v1 = InstructionSet::CMOV() && InstructionSet::CX8() && InstructionSet::FPU()
+                 && InstructionSet::FXSR() && InstructionSet::MMX() && InstructionSet::SSE()
+                 && InstructionSet::SSE2();
+
+    const bool v2 = v1 && InstructionSet::CMPXCHG16B() && InstructionSet::LAHF()
+                 && InstructionSet::POPCNT() && InstructionSet::SSE3() && InstructionSet::SSE41()
+                 && InstructionSet::SSE42() && InstructionSet::SSSE3();
+
+    const bool v3 = v2 && InstructionSet::AVX() && InstructionSet::AVX2() && InstructionSet::BMI1()
+                 && InstructionSet::BMI2() && InstructionSet::F16C() && InstructionSet::FMA()
+                 && InstructionSet::ABM() /* LZCNT */ && InstructionSet::MOVBE() && InstructionSet::OSXSAVE()
+                 && isAvxStateEnabled(xcr0);
+
+    const bool v4 = v3 && InstructionSet::AVX512F() && InstructionSet::AVX512BW()
+                 && InstructionSet::AVX512CD() && InstructionSet::AVX512DQ() && InstructionSet::AVX512VL()
+                 && isAvx512StateEnabled(xcr0);
+
+    if(v4) { return 4; } else
+    if(v3) { return 3; } else
+    if(v2) { return 2; } else
+    if(v1) { return 1; } else
+           { return 0; }
+}
+int getArchitectureLevel()
+{
+    return getArchitectureLevel(InstructionSet::XCR0());
+}
+inline std::string getArchitectureName(int level)
+{
+    return (level > 0) ? "x86-64-v" + std::to_string(level) : "x86-64";
+}
+
+/**
+ * Describes the cpu in the common json schema. It is filled by one of the backends:
+ * describeX86() uses the CPUID instruction, describeAarch64() the hwcaps of the Linux kernel.
+ * The values of isa_features and mitigations are json values, e.g. "true" or "256".
+ */
+struct CpuDescription
+{
+    std::string vendor;
+    std::string brand;
+    std::string architecture;
+    std::vector<std::pair<std::string, std::string>> isa_features;   // booleans only
+    std::vector<std::pair<std::string, std::string>> vector_lengths; // numbers, e.g. the SVE vector length
+    std::vector<std::pair<std::string, std::string>> mitigations;
+};
+
+CpuDescription describeX86()
+{
+    CpuDescription cpu;
+
+    // collect the json key value pair
+    auto print_pair = [&cpu](std::string key, bool val) {
+        cpu.isa_features.emplace_back(key, val ? "true" : "false");
     };
 
     print_pair("3DNOW",            InstructionSet::_3DNOW());
@@ -443,21 +761,1021 @@ int main()
     print_pair("XOP",              InstructionSet::XOP());
     print_pair("XSAVE",            InstructionSet::XSAVE());
 
+    // speculative-execution mitigations
+    auto print_mitigation = [&cpu](std::string key, bool val) {
+        cpu.mitigations.emplace_back(key, val ? "true" : "false");
+    };
+
+    print_mitigation("IBRS_IBPB",         InstructionSet::IBRS_IBPB());
+    print_mitigation("STIBP",             InstructionSet::STIBP());
+    print_mitigation("SSBD",              InstructionSet::SSBD());
+    print_mitigation("MD_CLEAR",          InstructionSet::MD_CLEAR());
+    print_mitigation("L1D_FLUSH",         InstructionSet::L1D_FLUSH());
+    print_mitigation("ARCH_CAPABILITIES", InstructionSet::ARCH_CAPABILITIES());
+    print_mitigation("AMD_IBPB",          InstructionSet::AMD_IBPB());
+    print_mitigation("AMD_IBRS",          InstructionSet::AMD_IBRS());
+    print_mitigation("AMD_STIBP",         InstructionSet::AMD_STIBP());
+    print_mitigation("AMD_SSBD",          InstructionSet::AMD_SSBD());
+
+    cpu.vendor = InstructionSet::Vendor();
+    std::string brand = InstructionSet::Brand();
+    cpu.brand = trim(brand);
+    cpu.architecture = getArchitectureName(getArchitectureLevel());
+
+    return cpu;
+}
+
+// Feature names of the Linux hwcaps, indexed by bit, as listed in the "Features" line of /proc/cpuinfo.
+static const char* const AARCH64_HWCAP_NAMES[32] = {
+    "fp", "asimd", "evtstrm", "aes", "pmull", "sha1", "sha2", "crc32",
+    "atomics", "fphp", "asimdhp", "cpuid", "asimdrdm", "jscvt", "fcma", "lrcpc",
+    "dcpop", "sha3", "sm3", "sm4", "asimddp", "sha512", "sve", "asimdfhm",
+    "dit", "uscat", "ilrcpc", "flagm", "ssbs", "sb", "paca", "pacg"
+};
+static const char* const AARCH64_HWCAP2_NAMES[24] = {
+    "dcpodp", "sve2", "sveaes", "svepmull", "svebitperm", "svesha3", "svesm4", "flagm2",
+    "frint", "svei8mm", "svef32mm", "svef64mm", "svebf16", "i8mm", "bf16", "dgh",
+    "rng", "bti", "mte", "ecv", "afp", "rpres", "mte3", "sme"
+};
+
+// "CPU implementer" and "CPU part" of /proc/cpuinfo (MIDR_EL1), part 0 names the implementer.
+struct Aarch64Part { int implementer; int part; const char* name; };
+static const Aarch64Part AARCH64_PARTS[] = {
+    { 0x41, 0,     "ARM"         },
+    { 0x41, 0xd03, "Cortex-A53"  },
+    { 0x41, 0xd07, "Cortex-A57"  },
+    { 0x41, 0xd08, "Cortex-A72"  },
+    { 0x41, 0xd0b, "Cortex-A76"  },
+    { 0x41, 0xd0c, "Neoverse-N1" },
+    { 0x41, 0xd40, "Neoverse-V1" },
+    { 0x41, 0xd49, "Neoverse-N2" },
+    { 0x41, 0xd4f, "Neoverse-V2" },
+    { 0x42, 0,     "Broadcom"    },
+    { 0x43, 0,     "Cavium"      },
+    { 0x48, 0,     "HiSilicon"   },
+    { 0x4e, 0,     "NVIDIA"      },
+    { 0x51, 0,     "Qualcomm"    },
+    { 0x61, 0,     "Apple"       },
+    { 0xc0, 0,     "Ampere"      },
+    { 0xc0, 0xac3, "Ampere-1"    },
+    { 0xc0, 0xac4, "Ampere-1a"   }
+};
+
+/**
+ * AArch64 backend: decodes the hwcaps (AT_HWCAP, AT_HWCAP2) and /proc/cpuinfo of the Linux kernel.
+ *
+ * All files are read relative to a root directory. An empty root reads the running system.
+ * Any other root is a captured system (fixture), which can be decoded on any host:
+ *
+ *   <root>/auxv                                      output of "LD_SHOW_AUXV=1 /bin/true", instead of getauxval()
+ *   <root>/proc/cpuinfo
+ *   <root>/proc/sys/abi/sve_default_vector_length    SVE vector length in bytes, instead of prctl()
+ */
+class Aarch64Features
+{
+public:
+    explicit Aarch64Features(const std::string& root)
+        : sve_vector_length_{ 0 },
+        hwcap_{ 0 },
+        hwcap2_{ 0 }
+    {
+        if (!root.empty())
+        {
+            std::ifstream auxv(root + "/auxv");
+            parseAuxv(auxv);
+        }
+#if defined(__aarch64__) && defined(__linux__)
+        else
+        {
+            hwcap_  = getauxval(AT_HWCAP);
+#ifdef AT_HWCAP2
+            hwcap2_ = getauxval(AT_HWCAP2);
+#endif
+        }
+#endif
+
+        // the "Features" line lists the same hwcaps, it fills in for a fixture without auxv
+        std::ifstream cpuinfo(root + "/proc/cpuinfo");
+        parseProcCpuinfo(cpuinfo);
+
+        if (SVE())
+        {
+#if defined(__aarch64__) && defined(__linux__) && defined(PR_SVE_GET_VL)
+            if (root.empty())
+            {
+                const int vl = prctl(PR_SVE_GET_VL);
+                if (vl >= 0) { sve_vector_length_ = (vl & PR_SVE_VL_LEN_MASK) * 8; }
+            }
+#endif
+            std::ifstream default_vl(root + "/proc/sys/abi/sve_default_vector_length");
+            int bytes = 0;
+            if (sve_vector_length_ == 0 && default_vl >> bytes) { sve_vector_length_ = bytes * 8; }
+        }
+    }
+
+    // getters
+    std::string Vendor(void) const { return vendor_; }
+    std::string Brand(void)  const { return brand_;  }
+    int SVE_VL(void)         const { return sve_vector_length_; } // SVE vector length in bits, 0 without SVE
+
+    // Linux AT_HWCAP, word 0
+
+    bool FP(void)        const { return hwcap_[0];  } // Floating-point
+    bool ASIMD(void)     const { return hwcap_[1];  } // Advanced SIMD, NEON
+    bool AES(void)       const { return hwcap_[3];  } // AES instructions
+    bool PMULL(void)     const { return hwcap_[4];  } // Polynomial multiply long
+    bool SHA1(void)      const { return hwcap_[5];  } // SHA1 instructions
+    bool SHA2(void)      const { return hwcap_[6];  } // SHA256 instructions
+    bool CRC32(void)     const { return hwcap_[7];  } // CRC32 instructions
+    bool ATOMICS(void)   const { return hwcap_[8];  } // Large System Extensions (LSE) atomics
+    bool FPHP(void)      const { return hwcap_[9];  } // Half-precision floating-point
+    bool ASIMDHP(void)   const { return hwcap_[10]; } // Half-precision Advanced SIMD
+    bool ASIMDRDM(void)  const { return hwcap_[12]; } // Rounding double multiply accumulate
+    bool JSCVT(void)     const { return hwcap_[13]; } // JavaScript conversion FJCVTZS
+    bool FCMA(void)      const { return hwcap_[14]; } // Complex number multiply-add
+    bool LRCPC(void)     const { return hwcap_[15]; } // Load-acquire RCpc LDAPR
+    bool DCPOP(void)     const { return hwcap_[16]; } // DC CVAP, clean to point of persistence
+    bool SHA3(void)      const { return hwcap_[17]; } // SHA3 instructions
+    bool SM3(void)       const { return hwcap_[18]; } // SM3 instructions
+    bool SM4(void)       const { return hwcap_[19]; } // SM4 instructions
+    bool ASIMDDP(void)   const { return hwcap_[20]; } // Dot product SDOT, UDOT
+    bool SHA512(void)    const { return hwcap_[21]; } // SHA512 instructions
+    bool SVE(void)       const { return hwcap_[22]; } // Scalable Vector Extension
+    bool ASIMDFHM(void)  const { return hwcap_[23]; } // Half-precision FMLAL, FMLSL
+    bool DIT(void)       const { return hwcap_[24]; } // Data independent timing
+    bool USCAT(void)     const { return hwcap_[25]; } // Unaligned single-copy atomicity
+    bool ILRCPC(void)    const { return hwcap_[26]; } // Load-acquire RCpc with immediate offset
+    bool FLAGM(void)     const { return hwcap_[27]; } // Flag manipulation
+    bool SSBS(void)      const { return hwcap_[28]; } // Speculative Store Bypass Safe
+    bool SB(void)        const { return hwcap_[29]; } // Speculation barrier
+    bool PACA(void)      const { return hwcap_[30]; } // Pointer authentication, address
+    bool PACG(void)      const { return hwcap_[31]; } // Pointer authentication, generic
+
+    // Linux AT_HWCAP2, word 1
+
+    bool DCPODP(void)    const { return hwcap2_[0];  } // DC CVADP, clean to point of deep persistence
+    bool SVE2(void)      const { return hwcap2_[1];  } // Scalable Vector Extension 2
+    bool SVEAES(void)    const { return hwcap2_[2];  } // SVE2 AES instructions
+    bool SVEPMULL(void)  const { return hwcap2_[3];  } // SVE2 polynomial multiply long
+    bool SVEBITPERM(void)const { return hwcap2_[4];  } // SVE2 bit permute
+    bool SVESHA3(void)   const { return hwcap2_[5];  } // SVE2 SHA3 instructions
+    bool SVESM4(void)    const { return hwcap2_[6];  } // SVE2 SM4 instructions
+    bool FLAGM2(void)    const { return hwcap2_[7];  } // Flag manipulation 2
+    bool FRINT(void)     const { return hwcap2_[8];  } // Floating-point round to integer FRINT32Z, ...
+    bool SVEI8MM(void)   const { return hwcap2_[9];  } // SVE int8 matrix multiply
+    bool SVEF32MM(void)  const { return hwcap2_[10]; } // SVE fp32 matrix multiply
+    bool SVEF64MM(void)  const { return hwcap2_[11]; } // SVE fp64 matrix multiply
+    bool SVEBF16(void)   const { return hwcap2_[12]; } // SVE BFloat16
+    bool I8MM(void)      const { return hwcap2_[13]; } // Advanced SIMD int8 matrix multiply
+    bool BF16(void)      const { return hwcap2_[14]; } // Advanced SIMD BFloat16
+    bool RNG(void)       const { return hwcap2_[16]; } // Random number RNDR, RNDRRS
+    bool BTI(void)       const { return hwcap2_[17]; } // Branch target identification
+    bool MTE(void)       const { return hwcap2_[18]; } // Memory tagging
+    bool SME(void)       const { return hwcap2_[23]; } // Scalable Matrix Extension
+
+    /**
+     * Determines the architecture level as GCC/Clang -march value, e.g. "armv8.2-a".
+     * This is the highest level, whose characteristic features are all present.
+     * Optional features of a level (e.g. SVE) are not required.
+     */
+    std::string Architecture(void) const
+    {
+        const bool v8_0 = FP() && ASIMD();
+        const bool v8_1 = v8_0 && ATOMICS() && ASIMDRDM() && CRC32();
+        const bool v8_2 = v8_1 && DCPOP();
+        const bool v8_3 = v8_2 && JSCVT() && FCMA() && LRCPC();
+        const bool v8_4 = v8_3 && DIT() && USCAT() && ILRCPC() && FLAGM() && ASIMDDP();
+        const bool v8_5 = v8_4 && SB() && FLAGM2() && FRINT();
+        const bool v8_6 = v8_5 && BF16() && I8MM();
+        const bool v9_0 = v8_5 && SVE2();
+
+        if(v9_0) { return "armv9-a";   } else
+        if(v8_6) { return "armv8.6-a"; } else
+        if(v8_5) { return "armv8.5-a"; } else
+        if(v8_4) { return "armv8.4-a"; } else
+        if(v8_3) { return "armv8.3-a"; } else
+        if(v8_2) { return "armv8.2-a"; } else
+        if(v8_1) { return "armv8.1-a"; } else
+        if(v8_0) { return "armv8-a";   } else
+                 { return "aarch64";   }
+    }
+
+private:
+    // split "key : value" lines of /proc/cpuinfo and of LD_SHOW_AUXV output
+    static bool splitLine(const std::string& line, std::string& key, std::string& value)
+    {
+        const std::string::size_type colon = line.find(':');
+        if (colon == std::string::npos) { return false; }
+        key   = trim_whitespace(line.substr(0, colon));
+        value = trim_whitespace(line.substr(colon + 1));
+        return true;
+    }
+
+    // set the hwcap bits of a space separated list of feature names
+    void setFeatures(const std::string& names)
+    {
+        std::istringstream iss(names);
+        std::string name;
+        while (iss >> name)
+        {
+            for (std::size_t i = 0; i < hwcap_.size(); ++i) {
+                if (name == AARCH64_HWCAP_NAMES[i]) { hwcap_[i] = true; }
+            }
+            for (std::size_t i = 0; i < sizeof(AARCH64_HWCAP2_NAMES) / sizeof(AARCH64_HWCAP2_NAMES[0]); ++i) {
+                if (name == AARCH64_HWCAP2_NAMES[i]) { hwcap2_[i] = true; }
+            }
+        }
+    }
+
+    // glibc prints the hwcaps either as hex number or as list of names
+    void parseAuxv(std::istream& in)
+    {
+        std::string line, key, value;
+        while (std::getline(in, line))
+        {
+            if (!splitLine(line, key, value) || (key != "AT_HWCAP" && key != "AT_HWCAP2")) { continue; }
+
+            if (value.compare(0, 2, "0x") == 0)
+            {
+                const std::bitset<32> bits(std::strtoull(value.c_str(), nullptr, 16));
+                if (key == "AT_HWCAP") { hwcap_ |= bits; } else { hwcap2_ |= bits; }
+            }
+            else
+            {
+                setFeatures(value);
+            }
+        }
+    }
+
+    // the first processor block is enough, the kernel reports the same features for all cores
+    void parseProcCpuinfo(std::istream& in)
+    {
+        int implementer = -1;
+        int part = -1;
+        bool has_features = false;
+
+        std::string line, key, value;
+        while (std::getline(in, line))
+        {
+            if (!splitLine(line, key, value)) { continue; }
+
+            if (key == "Features" && !has_features) {
+                setFeatures(value);
+                has_features = true;
+            } else if (key == "CPU implementer" && implementer < 0) {
+                implementer = static_cast<int>(std::strtol(value.c_str(), nullptr, 16));
+            } else if (key == "CPU part" && part < 0) {
+                part = static_cast<int>(std::strtol(value.c_str(), nullptr, 16));
+            }
+        }
+
+        for (const Aarch64Part& entry : AARCH64_PARTS)
+        {
+            if (entry.implementer != implementer) { continue; }
+            if (entry.part == 0)    { vendor_ = entry.name; }
+            if (entry.part == part) { brand_  = entry.name; }
+        }
+        if (brand_.empty() && part >= 0)
+        {
+            std::stringstream ss;
+            ss << vendor_ << " part 0x" << std::hex << part;
+            brand_ = trim_whitespace(ss.str());
+        }
+    }
+
+    std::string vendor_;
+    std::string brand_;
+    int sve_vector_length_;
+    std::bitset<32> hwcap_;
+    std::bitset<32> hwcap2_;
+};
+
+CpuDescription describeAarch64(const std::string& root)
+{
+    const Aarch64Features arm(root);
+    CpuDescription cpu;
+
+    // collect the json key value pair
+    auto print_pair = [&cpu](std::string key, bool val) {
+        cpu.isa_features.emplace_back(key, val ? "true" : "false");
+    };
+
+    print_pair("AES",              arm.AES());
+    print_pair("ASIMD",            arm.ASIMD());
+    print_pair("ASIMDRDM",         arm.ASIMDRDM());
+    print_pair("BF16",             arm.BF16());
+    print_pair("BTI",              arm.BTI());
+    print_pair("CRC32",            arm.CRC32());
+    print_pair("DOTPROD",          arm.ASIMDDP());
+    print_pair("FCMA",             arm.FCMA());
+    print_pair("FHM",              arm.ASIMDFHM());
+    print_pair("FP",               arm.FP());
+    print_pair("FP16",             arm.FPHP() && arm.ASIMDHP());
+    print_pair("I8MM",             arm.I8MM());
+    print_pair("JSCVT",            arm.JSCVT());
+    print_pair("LRCPC",            arm.LRCPC());
+    print_pair("LSE",              arm.ATOMICS());
+    print_pair("MTE",              arm.MTE());
+    print_pair("NEON",             arm.ASIMD());
+    print_pair("PACA",             arm.PACA());
+    print_pair("PMULL",            arm.PMULL());
+    print_pair("RNG",              arm.RNG());
+    print_pair("SHA1",             arm.SHA1());
+    print_pair("SHA2",             arm.SHA2());
+    print_pair("SHA3",             arm.SHA3());
+    print_pair("SHA512",           arm.SHA512());
+    print_pair("SM3",              arm.SM3());
+    print_pair("SM4",              arm.SM4());
+    print_pair("SME",              arm.SME());
+    print_pair("SVE",              arm.SVE());
+    print_pair("SVE2",             arm.SVE2());
+    print_pair("SVE_BF16",         arm.SVEBF16());
+    print_pair("SVE_I8MM",         arm.SVEI8MM());
+
+    // vector length in bits, 0 without SVE
+    cpu.vector_lengths.emplace_back("sve_vector_length", std::to_string(arm.SVE_VL()));
+
+    // speculative-execution mitigations
+    auto print_mitigation = [&cpu](std::string key, bool val) {
+        cpu.mitigations.emplace_back(key, val ? "true" : "false");
+    };
+
+    print_mitigation("SSBS", arm.SSBS());
+    print_mitigation("SB",   arm.SB());
+    print_mitigation("BTI",  arm.BTI());
+
+    cpu.vendor       = arm.Vendor();
+    cpu.brand        = arm.Brand();
+    cpu.architecture = arm.Architecture();
+
+    return cpu;
+}
+
+/**
+ * Reads the cache sizes of cpu0 from <root>/sys/devices/system/cpu/cpu0/cache/index*.
+ * Returns json key value pairs with sizes in bytes, e.g. "L1d": 65536, "L2": 1048576, "line_size": 64.
+ */
+std::vector<std::pair<std::string, std::string>> getCacheInfo(const std::string& root)
+{
+    std::vector<std::pair<std::string, std::string>> caches;
+    int line_size = 0;
+
+    for (int index = 0; index < 16; ++index)
+    {
+        const std::string dir = root + "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::ifstream level_file(dir + "level");
+        std::ifstream type_file(dir + "type");
+        std::ifstream size_file(dir + "size");
+        std::ifstream line_file(dir + "coherency_line_size");
+
+        int level = 0;
+        std::string type;
+        std::string size;
+        if (!(level_file >> level) || !(type_file >> type) || !(size_file >> size)) { break; }
+
+        // "48K", "1024K" or "32M"
+        long long bytes = std::strtoll(size.c_str(), nullptr, 10);
+        if (size.back() == 'K') { bytes *= 1024; }
+        if (size.back() == 'M') { bytes *= 1024 * 1024; }
+
+        std::string name = "L";
+        name += std::to_string(level);
+        if (type == "Data")        { name += "d"; }
+        if (type == "Instruction") { name += "i"; }
+        caches.emplace_back(name, std::to_string(bytes));
+
+        int line = 0;
+        if (line_size == 0 && line_file >> line) { line_size = line; }
+    }
+
+    if (line_size > 0) { caches.emplace_back("line_size", std::to_string(line_size)); }
+
+    return caches;
+}
+
+/**
+ * Multi-variant launcher: "cpuinfo exec --variants dir/ -- args..."
+ *
+ * The variants directory contains one executable per architecture level,
+ * with the level at the end of its file name, e.g. "service.x86-64-v1" to "service.x86-64-v4".
+ * The variant with the highest level supported by the host is exec'd in place of
+ * this process, so no launcher process is left running. If exec fails, the next-best
+ * variant is tried. The choice is logged to the
+ * CPUINFO_VARIANT and CPUINFO_VARIANT_REASON environment variables.
+ */
+int execVariant(int argc, char* argv[])
+{
+    if (argc < 5 || std::string(argv[2]) != "--variants" || std::string(argv[4]) != "--")
+    {
+        std::cerr << "Usage: cpuinfo exec --variants <dir> -- [args...]" << std::endl;
+        return 2;
+    }
+
+#if defined(__linux__)
+    std::string dir = argv[3];
+    if (dir.empty() || dir.back() != '/') { dir += '/'; }
+
+    const int host_level = getArchitectureLevel();
+
+    // collect the executable regular files named "...x86-64-vN"
+    std::vector<std::pair<int, std::string>> variants;
+    int candidates = 0;
+
+    DIR* handle = opendir(dir.c_str());
+    if (handle == nullptr)
+    {
+        std::cerr << "[CPUINFO] Could not open variants directory: " << dir << std::endl;
+        return 1;
+    }
+
+    const std::string suffix = "x86-64-v";
+    while (struct dirent* entry = readdir(handle))
+    {
+        const std::string name = entry->d_name;
+        if (name.size() <= suffix.size()) { continue; }
+        if (name.compare(name.size() - suffix.size() - 1, suffix.size(), suffix) != 0) { continue; }
+
+        const int level = name.back() - '0';
+        if (level < 1 || level > 4) { continue; }
+
+        struct stat info;
+        if (stat((dir + name).c_str(), &info) != 0 || !S_ISREG(info.st_mode)) { continue; }
+        if (access((dir + name).c_str(), X_OK) != 0) { continue; }
+
+        ++candidates;
+        if (level <= host_level) { variants.emplace_back(level, name); }
+    }
+    closedir(handle);
+
+    if (variants.empty())
+    {
+        std::cerr << "[CPUINFO] No variant in " << dir << " runs on host level "
+                  << getArchitectureName(host_level) << std::endl;
+        return 1;
+    }
+
+    // highest compatible level first, ties are resolved by file name
+    std::sort(variants.begin(), variants.end(),
+        [](const std::pair<int, std::string>& a, const std::pair<int, std::string>& b) {
+            return (a.first != b.first) ? a.first > b.first : a.second < b.second;
+        });
+
+    // if a variant can not be exec'd, fall back to the next-best one
+    std::string failures;
+    for (const auto& variant : variants)
+    {
+        const std::string path = dir + variant.second;
+        const std::string reason = "host is " + getArchitectureName(host_level) + ", selected "
+            + getArchitectureName(variant.first) + " out of " + std::to_string(candidates) + " variants"
+            + failures;
+
+        setenv("CPUINFO_VARIANT", path.c_str(), 1);
+        setenv("CPUINFO_VARIANT_REASON", reason.c_str(), 1);
+
+        std::vector<char*> args;
+        args.push_back(const_cast<char*>(path.c_str()));
+        for (int i = 5; i < argc; ++i) {
+            args.push_back(argv[i]);
+        }
+        args.push_back(nullptr);
+
+        execv(path.c_str(), args.data());
+
+        // only reached, if exec failed
+        const std::string error = strerror(errno);
+        std::cerr << "[CPUINFO] Could not exec " << path << ": " << error << std::endl;
+        failures += ", " + variant.second + " failed: " + error;
+    }
+    return 127;
+#else
+    std::cerr << "[CPUINFO] exec is only supported on Linux." << std::endl;
+    return 1;
+#endif
+}
+
+#if defined(__linux__)
+/**
+ * Continuous frequency and throttling monitor: "cpuinfo monitor".
+ *
+ * Samples per core:
+ *  - the frequency of the cpufreq driver (sysfs scaling_cur_freq)
+ *  - the busy frequency, TSC rate * delta APERF / delta MPERF, if /dev/cpu/N/msr is readable (root, msr module)
+ * and the thermal throttle counters and the package temperature.
+ *
+ * All files are opened once and re-read with pread(), so a sample costs a few syscalls per core.
+ * Like the aarch64 backend, all paths are relative to a root directory, which is empty for the running system.
+ */
+class FrequencyMonitor
+{
+public:
+    struct Sample
+    {
+        double time_s = 0;                 // seconds since the first sample
+        std::vector<double> mhz;           // per core, cpufreq, -1 if unknown
+        std::vector<double> busy_mhz;      // per core, APERF/MPERF, -1 if unknown, empty without msr access
+        long long core_throttle = -1;      // sum of core_throttle_count of all cores, -1 if unknown
+        long long package_throttle = -1;   // package_throttle_count of cpu0, -1 if unknown
+        double temp_c = -1;                // package temperature, -1 if unknown
+    };
+
+    explicit FrequencyMonitor(const std::string& root)
+        : temp_fd_{ -1 },
+        package_throttle_fd_{ -1 },
+        has_msr_{ false }
+    {
+        const std::string cpu_dir = root + "/sys/devices/system/cpu/cpu";
+        for (int cpu = 0; cpu < 4096 && access((cpu_dir + std::to_string(cpu)).c_str(), F_OK) == 0; ++cpu)
+        {
+            const std::string dir = cpu_dir + std::to_string(cpu);
+            freq_fds_.push_back(openFile(dir + "/cpufreq/scaling_cur_freq"));
+            throttle_fds_.push_back(openFile(dir + "/thermal_throttle/core_throttle_count"));
+            msr_fds_.push_back(root.empty() ? openFile("/dev/cpu/" + std::to_string(cpu) + "/msr") : -1);
+        }
+        package_throttle_fd_ = openFile(cpu_dir + "0/thermal_throttle/package_throttle_count");
+
+        // APERF/MPERF only, if all cores are readable
+        has_msr_ = !msr_fds_.empty()
+            && std::find(msr_fds_.begin(), msr_fds_.end(), -1) == msr_fds_.end();
+        aperf_.assign(msr_fds_.size(), 0);
+        mperf_.assign(msr_fds_.size(), 0);
+
+        // package temperature: thermal zone "x86_pkg_temp", else the first cpu hwmon
+        for (int zone = 0; zone < 64 && temp_fd_ < 0; ++zone)
+        {
+            const std::string dir = root + "/sys/class/thermal/thermal_zone" + std::to_string(zone);
+            std::ifstream type_file(dir + "/type");
+            std::string type;
+            if (!(type_file >> type)) { break; }
+            if (type == "x86_pkg_temp") { temp_fd_ = openFile(dir + "/temp"); }
+        }
+        for (int hwmon = 0; hwmon < 64 && temp_fd_ < 0; ++hwmon)
+        {
+            const std::string dir = root + "/sys/class/hwmon/hwmon" + std::to_string(hwmon);
+            std::ifstream name_file(dir + "/name");
+            std::string name;
+            if (!(name_file >> name)) { break; }
+            if (name == "coretemp" || name == "k10temp" || name == "zenpower") { temp_fd_ = openFile(dir + "/temp1_input"); }
+        }
+
+        start_ = std::chrono::steady_clock::now();
+        last_ = start_;
+#if defined(__i386__) || defined(__x86_64__)
+        last_tsc_ = __rdtsc();
+#endif
+        readMsrs(aperf_, mperf_);
+    }
+
+    ~FrequencyMonitor()
+    {
+        for (int fd : freq_fds_)     { if (fd >= 0) { close(fd); } }
+        for (int fd : throttle_fds_) { if (fd >= 0) { close(fd); } }
+        for (int fd : msr_fds_)      { if (fd >= 0) { close(fd); } }
+        if (package_throttle_fd_ >= 0) { close(package_throttle_fd_); }
+        if (temp_fd_ >= 0)             { close(temp_fd_); }
+    }
+
+    FrequencyMonitor(const FrequencyMonitor&) = delete;
+    FrequencyMonitor& operator=(const FrequencyMonitor&) = delete;
+
+    int Cpus(void)   const { return static_cast<int>(freq_fds_.size()); }
+    bool HasMsr(void) const { return has_msr_; }
+
+    Sample sample()
+    {
+        Sample s;
+        const auto now = std::chrono::steady_clock::now();
+        s.time_s = std::chrono::duration<double>(now - start_).count();
+
+        for (int fd : freq_fds_)
+        {
+            const long long khz = readNumber(fd);
+            s.mhz.push_back(khz < 0 ? -1 : khz / 1000.0);
+        }
+
+        if (has_msr_)
+        {
+            double tsc_mhz = -1;
+#if defined(__i386__) || defined(__x86_64__)
+            const unsigned long long tsc = __rdtsc();
+            const double elapsed_us = std::chrono::duration<double, std::micro>(now - last_).count();
+            if (elapsed_us > 0) { tsc_mhz = (tsc - last_tsc_) / elapsed_us; }
+            last_tsc_ = tsc;
+#endif
+            std::vector<unsigned long long> aperf(aperf_.size(), 0);
+            std::vector<unsigned long long> mperf(mperf_.size(), 0);
+            readMsrs(aperf, mperf);
+            for (std::size_t cpu = 0; cpu < aperf.size(); ++cpu)
+            {
+                const unsigned long long delta_aperf = aperf[cpu] - aperf_[cpu];
+                const unsigned long long delta_mperf = mperf[cpu] - mperf_[cpu];
+                s.busy_mhz.push_back((tsc_mhz < 0 || delta_mperf == 0)
+                    ? -1 : tsc_mhz * static_cast<double>(delta_aperf) / static_cast<double>(delta_mperf));
+            }
+            aperf_.swap(aperf);
+            mperf_.swap(mperf);
+        }
+        last_ = now;
+
+        for (int fd : throttle_fds_)
+        {
+            const long long count = readNumber(fd);
+            if (count >= 0) { s.core_throttle = (s.core_throttle < 0 ? 0 : s.core_throttle) + count; }
+        }
+        s.package_throttle = readNumber(package_throttle_fd_);
+
+        const long long millidegrees = readNumber(temp_fd_);
+        s.temp_c = (millidegrees < 0) ? -1 : millidegrees / 1000.0;
+
+        return s;
+    }
+
+private:
+    static int openFile(const std::string& path)
+    {
+        return open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+
+    // sysfs attributes are regenerated, when they are read from offset 0
+    static long long readNumber(int fd)
+    {
+        if (fd < 0) { return -1; }
+        char buffer[32];
+        const ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+        if (n <= 0) { return -1; }
+        buffer[n] = 0;
+        return std::strtoll(buffer, nullptr, 10);
+    }
+
+    // IA32_MPERF 0xE7, IA32_APERF 0xE8, the msr device uses the register as file offset
+    void readMsrs(std::vector<unsigned long long>& aperf, std::vector<unsigned long long>& mperf) const
+    {
+        if (!has_msr_) { return; }
+        for (std::size_t cpu = 0; cpu < msr_fds_.size(); ++cpu)
+        {
+            if (pread(msr_fds_[cpu], &mperf[cpu], sizeof(mperf[cpu]), 0xE7) != sizeof(mperf[cpu])) { mperf[cpu] = 0; }
+            if (pread(msr_fds_[cpu], &aperf[cpu], sizeof(aperf[cpu]), 0xE8) != sizeof(aperf[cpu])) { aperf[cpu] = 0; }
+        }
+    }
+
+    std::vector<int> freq_fds_;
+    std::vector<int> throttle_fds_;
+    std::vector<int> msr_fds_;
+    int temp_fd_;
+    int package_throttle_fd_;
+    bool has_msr_;
+    std::vector<unsigned long long> aperf_;
+    std::vector<unsigned long long> mperf_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_;
+    unsigned long long last_tsc_ = 0;
+};
+
+inline std::string format_number(double value, int precision)
+{
+    if (value < 0) { return "null"; }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(precision) << value;
+    return ss.str();
+}
+inline double mean_of(const std::vector<double>& values)
+{
+    double sum = 0;
+    int count = 0;
+    for (double value : values) {
+        if (value >= 0) { sum += value; ++count; }
+    }
+    return (count > 0) ? sum / count : -1;
+}
+#endif
+
+/**
+ * "cpuinfo monitor [--interval <ms>] [--duration <s>] [--output <file>] [--format jsonl|csv] [-- command args...]"
+ *
+ * Test-only option: "--root <dir>" reads the sysfs files relative to <dir> (test/fixtures/monitor).
+ *
+ * Without command, samples are streamed until SIGINT/SIGTERM or the duration is over.
+ * With command, --duration is rejected, the command is run and sampled, until it exits. Then a frequency summary
+ * of its runtime is printed to stderr (and appended to a jsonl output) and the exit code
+ * of the command is returned. Samples are only streamed in this mode, if --output is given.
+ */
+int runMonitor(int argc, char* argv[])
+{
+    long interval_ms = 1000;
+    double duration_s = -1;
+    std::string output;
+    std::string format = "jsonl";
+    std::string root;
+    int command = -1;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--")                           { command = i + 1; break; }
+        else if (arg == "--interval" && has_value) { interval_ms = std::strtol(argv[++i], nullptr, 10); }
+        else if (arg == "--duration" && has_value) { duration_s = std::strtod(argv[++i], nullptr); }
+        else if (arg == "--output"   && has_value) { output = argv[++i]; }
+        else if (arg == "--format"   && has_value) { format = argv[++i]; }
+        else if (arg == "--root"     && has_value) { root = argv[++i]; }
+        else { interval_ms = 0; break; }
+    }
+    if (interval_ms <= 0 || (format != "jsonl" && format != "csv") || command == argc)
+    {
+        std::cerr << "Usage: cpuinfo monitor [--interval <ms>] [--duration <s>] [--output <file>]"
+                  << " [--format jsonl|csv] [-- command args...]" << std::endl;
+        return 2;
+    }
+    if (command > 0 && duration_s >= 0)
+    {
+        std::cerr << "[CPUINFO] monitor: --duration can't be combined with a command, the command's runtime is sampled." << std::endl;
+        return 2;
+    }
+
+#if defined(__linux__)
+    const bool wrapper = command > 0;
+
+    // samples go to the output file, to stdout, or nowhere (wrapper mode without --output)
+    FILE* out = nullptr;
+    if (!output.empty())
+    {
+        // close-on-exec, so the file descriptor doesn't leak into the command
+        const int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        out = (fd >= 0) ? fdopen(fd, "w") : nullptr;
+        if (out == nullptr)
+        {
+            if (fd >= 0) { close(fd); }
+            std::cerr << "[CPUINFO] Could not open monitor output: " << output << std::endl;
+            return 1;
+        }
+    }
+    else if (!wrapper)
+    {
+        out = stdout;
+    }
+
+    FrequencyMonitor monitor(root);
+
+    // wait for the end of the command or for a stop request with sigtimedwait(), instead of signal handlers
+    sigset_t signals;
+    sigset_t old_signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGCHLD);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, &old_signals);
+
+    pid_t child = -1;
+    if (wrapper)
+    {
+        child = fork();
+        if (child == 0)
+        {
+            sigprocmask(SIG_SETMASK, &old_signals, nullptr);
+            execvp(argv[command], argv + command);
+            std::cerr << "[CPUINFO] Could not exec " << argv[command] << ": " << strerror(errno) << std::endl;
+            _exit(127);
+        }
+        if (child < 0)
+        {
+            std::cerr << "[CPUINFO] Could not fork: " << strerror(errno) << std::endl;
+            return 1;
+        }
+    }
+
+    if (out != nullptr && format == "csv")
+    {
+        std::fprintf(out, "time_s,temp_c,core_throttle,package_throttle");
+        for (int cpu = 0; cpu < monitor.Cpus(); ++cpu) { std::fprintf(out, ",cpu%d_mhz", cpu); }
+        if (monitor.HasMsr()) {
+            for (int cpu = 0; cpu < monitor.Cpus(); ++cpu) { std::fprintf(out, ",cpu%d_busy_mhz", cpu); }
+        }
+        std::fprintf(out, "\n");
+    }
+
+    // summary of the mean frequency over all cores (busy frequency, if available)
+    double min_mhz = -1;
+    double max_mhz = -1;
+    double sum_mhz = 0;
+    int count_mhz = 0;
+    double max_temp_c = -1;
+    FrequencyMonitor::Sample first;
+    FrequencyMonitor::Sample last;
+    int exit_code = 0;
+    bool running = true;
+    bool first_sample = true;
+
+    while (running)
+    {
+        const long timeout_ms = first_sample ? 0 : interval_ms;
+        struct timespec timeout;
+        timeout.tv_sec  = timeout_ms / 1000;
+        timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+
+        siginfo_t info;
+        std::memset(&info, 0, sizeof(info));
+        const int sig = first_sample ? -1 : sigtimedwait(&signals, &info, &timeout);
+        if (sig == SIGCHLD && wrapper)
+        {
+            int status = 0;
+            if (waitpid(child, &status, WNOHANG) == child)
+            {
+                exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+                running = false;
+            }
+        }
+        else if (sig == SIGINT || sig == SIGTERM)
+        {
+            // Ctrl-C in the terminal (sent by the kernel, si_pid 0) reaches the command directly,
+            // because it is in the same foreground process group. Only forward signals of processes,
+            // e.g. "kill <monitor pid>", so the command doesn't get a second SIGINT.
+            if (!wrapper) { running = false; }
+            else if (info.si_pid != 0) { kill(child, sig); }
+        }
+
+        const FrequencyMonitor::Sample s = monitor.sample();
+        if (first_sample) { first = s; first_sample = false; }
+        last = s;
+        if (duration_s >= 0 && s.time_s >= duration_s) { running = false; }
+
+        const double mhz = mean_of(s.busy_mhz.empty() ? s.mhz : s.busy_mhz);
+        if (mhz >= 0)
+        {
+            if (min_mhz < 0 || mhz < min_mhz) { min_mhz = mhz; }
+            if (mhz > max_mhz) { max_mhz = mhz; }
+            sum_mhz += mhz;
+            ++count_mhz;
+        }
+        if (s.temp_c > max_temp_c) { max_temp_c = s.temp_c; }
+
+        if (out == nullptr) { continue; }
+
+        std::ostringstream line;
+        if (format == "csv")
+        {
+            // unknown values are empty fields
+            auto csv_field = [](double value, int precision) {
+                return (value < 0) ? std::string() : format_number(value, precision);
+            };
+            line << csv_field(s.time_s, 3) << "," << csv_field(s.temp_c, 1)
+                 << "," << csv_field(static_cast<double>(s.core_throttle), 0)
+                 << "," << csv_field(static_cast<double>(s.package_throttle), 0);
+            for (double value : s.mhz)      { line << "," << csv_field(value, 0); }
+            for (double value : s.busy_mhz) { line << "," << csv_field(value, 0); }
+            std::fprintf(out, "%s\n", line.str().c_str());
+        }
+        else
+        {
+            line << "{ \"time_s\": " << format_number(s.time_s, 3)
+                 << ", \"temp_c\": " << format_number(s.temp_c, 1)
+                 << ", \"core_throttle\": " << format_number(static_cast<double>(s.core_throttle), 0)
+                 << ", \"package_throttle\": " << format_number(static_cast<double>(s.package_throttle), 0)
+                 << ", \"mhz\": [";
+            for (std::size_t cpu = 0; cpu < s.mhz.size(); ++cpu) {
+                line << (cpu > 0 ? ", " : "") << format_number(s.mhz[cpu], 0);
+            }
+            line << "], \"busy_mhz\": [";
+            for (std::size_t cpu = 0; cpu < s.busy_mhz.size(); ++cpu) {
+                line << (cpu > 0 ? ", " : "") << format_number(s.busy_mhz[cpu], 0);
+            }
+            line << "] }";
+            std::fprintf(out, "%s\n", line.str().c_str());
+        }
+        std::fflush(out);
+    }
+
+    sigprocmask(SIG_SETMASK, &old_signals, nullptr);
+
+    if (wrapper)
+    {
+        const double avg_mhz = (count_mhz > 0) ? sum_mhz / count_mhz : -1;
+        const long long core_throttled = (first.core_throttle < 0) ? -1 : last.core_throttle - first.core_throttle;
+        const long long package_throttled = (first.package_throttle < 0) ? -1 : last.package_throttle - first.package_throttle;
+
+        // text for people: "n/a" instead of the json null
+        auto text = [](double value, const std::string& known) {
+            return (value < 0) ? std::string("n/a") : known;
+        };
+        std::cerr << "[CPUINFO] monitor: runtime " << format_number(last.time_s, 3) << " s"
+                  << ", exit code " << exit_code
+                  << ", " << (monitor.HasMsr() ? "busy" : "cpufreq") << " MHz min/avg/max "
+                  << text(min_mhz, format_number(min_mhz, 0) + "/" + format_number(avg_mhz, 0) + "/" + format_number(max_mhz, 0))
+                  << ", throttle core " << text(static_cast<double>(core_throttled), "+" + std::to_string(core_throttled))
+                  << " package " << text(static_cast<double>(package_throttled), "+" + std::to_string(package_throttled))
+                  << ", max temp " << text(max_temp_c, format_number(max_temp_c, 1) + " C") << std::endl;
+
+        if (out != nullptr && format == "jsonl")
+        {
+            std::fprintf(out, "%s\n", ("{ \"summary\": true, \"runtime_s\": " + format_number(last.time_s, 3)
+                + ", \"exit_code\": " + std::to_string(exit_code)
+                + ", \"mhz_min\": " + format_number(min_mhz, 0)
+                + ", \"mhz_avg\": " + format_number(avg_mhz, 0)
+                + ", \"mhz_max\": " + format_number(max_mhz, 0)
+                + ", \"core_throttle\": " + format_number(static_cast<double>(core_throttled), 0)
+                + ", \"package_throttle\": " + format_number(static_cast<double>(package_throttled), 0)
+                + ", \"temp_max_c\": " + format_number(max_temp_c, 1) + " }").c_str());
+        }
+    }
+
+    if (out != nullptr && out != stdout) { std::fclose(out); }
+
+    return exit_code;
+#else
+    (void) root;
+    (void) duration_s;
+    std::cerr << "[CPUINFO] monitor is only supported on Linux." << std::endl;
+    return 1;
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    // launcher mode, must stay fast: no json, no measurements
+    if (argc > 1 && std::string(argv[1]) == "exec")
+    {
+        return execVariant(argc, argv);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "monitor")
+    {
+        return runMonitor(argc, argv);
+    }
+
+    // "cpuinfo --aarch64-root <dir>" decodes a captured aarch64 system (fixture) instead of this host
+    const bool fixture = argc > 2 && std::string(argv[1]) == "--aarch64-root";
+    const std::string root = fixture ? argv[2] : "";
+
+#if defined(__aarch64__)
+    const CpuDescription cpu = describeAarch64(root);
+#else
+    const CpuDescription cpu = fixture ? describeAarch64(root) : describeX86();
+#endif
+
+    std::ostringstream outstream;
+
+    // print the json key value pair
+    auto print_pair = [&outstream](std::string key, auto val) {
+        outstream << "    \"" << key << "\": " << std::boolalpha << val << ",\n";
+    };
+
+    for (const auto& feature : cpu.isa_features) {
+        print_pair(feature.first, feature.second);
+    }
+
     // remove trailing comma from last item in isa-features
     std::string isa_feature = outstream.str();
     isa_feature = rm_last_char(isa_feature, ",");
 
-    // determine architecture level
-    std::string architecture;
-    if(InstructionSet::AVX512F()) { architecture = "x86-64-v4"; } else
-    if(InstructionSet::AVX2())    { architecture = "x86-64-v3"; } else
-    if(InstructionSet::SSE42())   { architecture = "x86-64-v2"; } else
-    if(InstructionSet::SSE2())    { architecture = "x86-64-v1"; } else
-                                  { architecture = "x86-64"; }
+    // cache sizes
+    outstream.str("");
 
-    std::string vendor = InstructionSet::Vendor();
-    std::string brand = InstructionSet::Brand();
-    brand = trim(brand);
+    for (const auto& cache : getCacheInfo(root)) {
+        print_pair(cache.first, cache.second);
+    }
+
+    std::string cache = outstream.str();
+    cache = rm_last_char(cache, ",");
+
+    // vector lengths (aarch64 only)
+    outstream.str("");
+
+    for (const auto& vector_length : cpu.vector_lengths) {
+        print_pair(vector_length.first, vector_length.second);
+    }
+
+    std::string vector_lengths = outstream.str();
+    vector_lengths = rm_last_char(vector_lengths, ",");
+
+    // speculative-execution mitigations: cpu support and kernel state
+    outstream.str("");
+
+    for (const auto& mitigation : cpu.mitigations) {
+        print_pair(mitigation.first, mitigation.second);
+    }
+
+    std::ostringstream vulnstream;
+    for (const auto& vulnerability : getVulnerabilities(root)) {
+        vulnstream << "        \"" << vulnerability.first << "\": \"" << vulnerability.second << "\"" << ",\n";
+    }
+    std::string vulnerabilities = vulnstream.str();
+    vulnerabilities = rm_last_char(vulnerabilities, ",");
+
+    outstream << "    \"vulnerabilities\": {" << "\n" << vulnerabilities << "\n" << "    }" << ",\n";
+
+    std::string mitigations = outstream.str();
+    mitigations = rm_last_char(mitigations, ",");
+
+    // measured kernel entry and context switch cost, of this host only
+    outstream.str("");
+
+    print_pair("syscall_ns",        format_ns(fixture ? -1 : measureSyscallNs()));
+    print_pair("context_switch_ns", format_ns(fixture ? -1 : measureContextSwitchNs()));
+
+    std::string kernel_overhead = outstream.str();
+    kernel_overhead = rm_last_char(kernel_overhead, ",");
+
+    const std::string architecture = cpu.architecture;
+    const std::string vendor       = cpu.vendor;
+    const std::string brand        = cpu.brand;
 
     std::string NL = "\n";  // double-escaped new line
 
@@ -471,6 +1789,10 @@ int main()
         "    \"brand\": \"" + brand + "\""                             +NL+
         " },"                                                          +NL+
         " \"isa-features\": {" + NL + isa_feature + NL + "  },"        +NL+
+        " \"cache\": {" + NL + cache + NL + "  },"                     +NL+
+        " \"vector\": {" + NL + vector_lengths + NL + "  },"           +NL+
+        " \"mitigations\": {" + NL + mitigations + NL + "  },"         +NL+
+        " \"kernel-overhead\": {" + NL + kernel_overhead + NL + "  }," +NL+
         " \"architecture\": \"" + architecture + "\""                  +NL+
         "}";
 
@@ -0,0 +1,23 @@
+// Autotune variant: sum of an array, no unrolling.
+// One accumulator, every addition waits for the previous one (floating-point adds are not reordered).
+
+#include <array>
+#include <cstdlib>
+
+static std::array<float, 4096> data_sum_unroll1;
+volatile float sink_sum_unroll1;
+
+// filled at runtime, so the compiler can't fold the sum to a constant
+static const bool filled_sum_unroll1 = [] {
+    for (float& value : data_sum_unroll1) { value = static_cast<float>(std::rand() % 100); }
+    return true;
+}();
+
+void cpuinfo_autotune_kernel()
+{
+    float sum = 0;
+    for (std::size_t i = 0; i < data_sum_unroll1.size(); ++i) {
+        sum += data_sum_unroll1[i];
+    }
+    sink_sum_unroll1 = sum;
+}
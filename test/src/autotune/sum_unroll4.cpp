@@ -0,0 +1,26 @@
+// Autotune variant: sum of an array, unrolled by 4 with independent accumulators.
+// Four dependency chains, so four additions are in flight at the same time.
+
+#include <array>
+#include <cstdlib>
+
+static std::array<float, 4096> data_sum_unroll4;
+volatile float sink_sum_unroll4;
+
+// filled at runtime, so the compiler can't fold the sum to a constant
+static const bool filled_sum_unroll4 = [] {
+    for (float& value : data_sum_unroll4) { value = static_cast<float>(std::rand() % 100); }
+    return true;
+}();
+
+void cpuinfo_autotune_kernel()
+{
+    float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    for (std::size_t i = 0; i < data_sum_unroll4.size(); i += 4) {
+        sum0 += data_sum_unroll4[i + 0];
+        sum1 += data_sum_unroll4[i + 1];
+        sum2 += data_sum_unroll4[i + 2];
+        sum3 += data_sum_unroll4[i + 3];
+    }
+    sink_sum_unroll4 = (sum0 + sum1) + (sum2 + sum3);
+}
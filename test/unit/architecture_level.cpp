@@ -0,0 +1,50 @@
+// Unit check of the XCR0 masks of the architecture level.
+// Includes cpuinfo.cpp, so that its internal functions can be called directly.
+
+#define main cpuinfo_main
+#include "../../src/cpuinfo.cpp"
+#undef main
+
+#include <cstdlib>
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+int main()
+{
+    // AVX needs XMM (bit 1) and YMM (bit 2)
+    check( isAvxStateEnabled(0x7),  "x87, XMM, YMM enable AVX");
+    check( isAvxStateEnabled(0x6),  "XMM, YMM enable AVX");
+    check(!isAvxStateEnabled(0x3),  "without YMM no AVX");
+    check(!isAvxStateEnabled(0x5),  "without XMM no AVX");
+    check(!isAvxStateEnabled(0x0),  "empty XCR0, no AVX");
+
+    // AVX-512 needs XMM, YMM and opmask, ZMM_Hi256, Hi16_ZMM (bits 5-7)
+    check( isAvx512StateEnabled(0xE7),  "x87, XMM, YMM, opmask, ZMM enable AVX-512");
+    check( isAvx512StateEnabled(0x2E7), "additional PKRU keeps AVX-512");
+    check(!isAvx512StateEnabled(0x7),   "without opmask/ZMM no AVX-512");
+    check(!isAvx512StateEnabled(0x67),  "without Hi16_ZMM no AVX-512");
+    check(!isAvx512StateEnabled(0xA7),  "without ZMM_Hi256 no AVX-512");
+    check(!isAvx512StateEnabled(0xC7),  "without opmask no AVX-512");
+    check(!isAvx512StateEnabled(0xE3),  "without YMM no AVX-512");
+
+    // whatever the host supports, the disabled register state caps the level
+    const int host_level = getArchitectureLevel();
+    check(getArchitectureLevel(0x3)  <= 2, "XCR0 without YMM caps the level at v2");
+    check(getArchitectureLevel(0x0)  <= 2, "XCR0 0 caps the level at v2");
+    check(getArchitectureLevel(0x7)  <= 3, "XCR0 without AVX-512 state caps the level at v3");
+    check(getArchitectureLevel(0x7)  == std::min(host_level, 3), "XCR0 with YMM keeps v3");
+    check(getArchitectureLevel(0x3)  == std::min(host_level, 2), "XCR0 without YMM keeps v2");
+    check(getArchitectureLevel(InstructionSet::XCR0()) == host_level, "the host level uses the host XCR0");
+
+    std::cout << "host " << getArchitectureName(host_level) << ", XCR0 0x" << std::hex << InstructionSet::XCR0()
+              << ", " << std::dec << failures << " failures" << std::endl;
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,26 @@
+# Checks that "cpuinfo exec" selects the variant of the host level out of v1 to v4
+# (test/fixtures/variants/select), so that variants above the host level are skipped.
+# The host level is taken from the "architecture" of cpuinfo.json.
+#
+# Usage: cmake -DCPUINFO=<cpuinfo> -DVARIANTS=<dir> -DWORK_DIR=<dir> -P exec_select.cmake
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+execute_process(COMMAND "${CPUINFO}" WORKING_DIRECTORY "${WORK_DIR}" OUTPUT_QUIET RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+  message(FATAL_ERROR "cpuinfo failed: ${RESULT}")
+endif()
+
+file(READ "${WORK_DIR}/cpuinfo.json" CPUINFO_JSON_STRING)
+string(JSON HOST_ARCHITECTURE GET "${CPUINFO_JSON_STRING}" "architecture")
+if(NOT HOST_ARCHITECTURE MATCHES "^x86-64-v[1-4]$")
+  message(FATAL_ERROR "No variant can run on host level ${HOST_ARCHITECTURE}")
+endif()
+
+execute_process(COMMAND "${CPUINFO}" exec --variants "${VARIANTS}" -- arg
+  OUTPUT_VARIABLE OUTPUT RESULT_VARIABLE RESULT)
+
+set(EXPECTED "selected [^ ]*/svc\\.${HOST_ARCHITECTURE} arg\nreason host is ${HOST_ARCHITECTURE}, selected ${HOST_ARCHITECTURE} out of 4 variants\n")
+if(NOT RESULT EQUAL 0 OR NOT OUTPUT MATCHES "^${EXPECTED}$")
+  message(FATAL_ERROR "Expected the ${HOST_ARCHITECTURE} variant, got (${RESULT}):\n${OUTPUT}")
+endif()
+message(STATUS "${OUTPUT}")